@@ -0,0 +1,107 @@
+// bench_nameindex.c — username lookups: strcmp loops vs. the fixed-width kernels
+//
+// Build from the repo root:
+//   gcc -O2 -Iinclude bench/bench_nameindex.c src/nameindex.c -o bench_nameindex -lpthread
+//   or: cmake -S . -B build && cmake --build build --target bench_nameindex
+// Run:
+//   ./bench_nameindex [users] [lookups]     (default 100000 x 2000000)
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nameindex.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//* The scan username_exists()/authenticate() did before the user index
+static int strcmp_scan(char (*names)[USERNAME_LEN], int n, const char *q) {
+    for (int i = 0; i < n; i++)
+        if (strcmp(names[i], q) == 0) return i;
+    return -1;
+}
+
+//* The hash table before the kernels: byte-wise FNV-1a, memcmp + terminator check
+typedef struct { char (*keys)[USERNAME_LEN]; int *values; int cap; } ByteTable;
+
+static unsigned fnv(const char *s, size_t len) {
+    unsigned h = 2166136261u;
+    for (size_t i = 0; i < len; i++) { h ^= (unsigned char)s[i]; h *= 16777619u; }
+    return h;
+}
+
+static int byte_slot(const ByteTable *t, const char *q, size_t len) {
+    int i = fnv(q, len) & (t->cap - 1);
+    while (t->keys[i][0] && !(memcmp(t->keys[i], q, len) == 0 && t->keys[i][len] == '\0'))
+        i = (i + 1) & (t->cap - 1);
+    return i;
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 100000;
+    int lookups = argc > 2 ? atoi(argv[2]) : 2000000;
+
+    char (*names)[USERNAME_LEN] = calloc(n, USERNAME_LEN);
+    //* a cache-resident pool of queries, cycled, so the table is what gets measured
+    enum { POOL = 4096 };
+    char (*queries)[USERNAME_LEN] = calloc(POOL, USERNAME_LEN);
+    if (!names || !queries) { fprintf(stderr, "out of memory\n"); return 1; }
+    for (int i = 0; i < n; i++)
+        snprintf(names[i], USERNAME_LEN, "student_%d_x", i);
+    srand(42);
+    for (int i = 0; i < POOL; i++) {
+        int r = rand() % (n * 2);  // half hits, half misses
+        snprintf(queries[i], USERNAME_LEN, r < n ? "student_%d_x" : "student_%d_y", r % n);
+    }
+    printf("users=%d lookups=%d (about 50%% hits)\n", n, lookups);
+
+    //* linear strcmp scan: far too slow for every query, time a sample
+    int sample = lookups < 2000 ? lookups : 2000;
+    long hits = 0;
+    double t0 = now_sec();
+    for (int i = 0; i < sample; i++) hits += strcmp_scan(names, n, queries[i % POOL]) >= 0;
+    double t = now_sec() - t0;
+    printf("strcmp scan        : %9.1f ns/lookup  hits=%ld of %d sampled\n", t / sample * 1e9, hits, sample);
+
+    ByteTable bt = { calloc(4 * n, USERNAME_LEN), malloc(4 * n * sizeof(int)), 1 };
+    while (bt.cap < 2 * n) bt.cap *= 2;
+    for (int i = 0; i < n; i++) {
+        int s = byte_slot(&bt, names[i], strlen(names[i]));
+        memcpy(bt.keys[s], names[i], USERNAME_LEN);
+        bt.values[s] = i;
+    }
+    hits = 0;
+    t0 = now_sec();
+    for (int i = 0; i < lookups; i++) {
+        const char *q = queries[i & (POOL - 1)];
+        int s = byte_slot(&bt, q, strlen(q));
+        hits += bt.keys[s][0] != '\0';
+    }
+    double base = now_sec() - t0;
+    printf("byte FNV + memcmp  : %9.1f ns/lookup  hits=%ld\n", base / lookups * 1e9, hits);
+
+    static const NameIndexKernel kernels[] = { NAME_KERNEL_SCALAR, NAME_KERNEL_SSE2, NAME_KERNEL_AVX2 };
+    int failures = 0;
+    for (size_t k = 0; k < sizeof kernels / sizeof *kernels; k++) {
+        if (name_index_use_kernel(kernels[k]) != 0) continue;  // unsupported here
+        NameIndex ix;
+        name_index_init(&ix, n);
+        for (int i = 0; i < n; i++) name_index_put(&ix, names[i], i);
+        long khits = 0;
+        t0 = now_sec();
+        for (int i = 0; i < lookups; i++) khits += name_index_get(&ix, queries[i & (POOL - 1)]) >= 0;
+        t = now_sec() - t0;
+        if (khits != hits) failures++;
+        printf("kernel %-11s : %9.1f ns/lookup  hits=%ld  (%.2fx)\n",
+               name_index_kernel(), t / lookups * 1e9, khits, base / t);
+        name_index_free(&ix);
+    }
+
+    free(bt.keys); free(bt.values);
+    free(names); free(queries);
+    return failures != 0;
+}
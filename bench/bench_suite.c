@@ -0,0 +1,176 @@
+// bench_suite.c — end-to-end timings of the hot paths on a generated election
+//
+// Build from the repo root:
+//   gcc -O2 -Iinclude bench/bench_suite.c $(ls src/*.c | grep -v src/main.c) -o bench_suite -lpthread
+//   or: cmake -S . -B build && cmake --build build --target bench_suite
+// Run:
+//   ./gen_election /tmp/elec 100000 50 80000
+//   ./bench_suite /tmp/elec [iterations]     (default 5)
+//
+// Prints one JSON object per line (JSON Lines): a "meta" record, then one
+// record per benchmark with the best and mean wall time per iteration.
+// record_new_vote and publish_results write to the data directory, so
+// regenerate it before comparing two runs.
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "models.h"
+#include "fileio.h"
+#include "state.h"
+#include "utils.h"
+#include "admin.h"
+#include "student.h"
+
+static FILE *report;  //* the real stdout; fd 1 points at /dev/null while timing
+static int iterations = 5;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void emit(const char *name, long items, int iters, double best, double total) {
+    fprintf(report, "{\"bench\":\"%s\",\"items\":%ld,\"iterations\":%d,"
+                    "\"best_s\":%.6f,\"mean_s\":%.6f,\"items_per_sec\":%.0f}\n",
+            name, items, iters, best, total / iters, best > 0 ? items / best : 0.0);
+    fflush(report);
+}
+
+//* Runs fn `iterations` times; setup (may be NULL) runs untimed before each call
+static void run(const char *name, long items, void (*setup)(void), void (*fn)(void)) {
+    double best = 1e30, total = 0;
+    for (int i = 0; i < iterations; i++) {
+        if (setup) setup();
+        double t0 = now_sec();
+        fn();
+        double dt = now_sec() - t0;
+        fflush(stdout);
+        total += dt;
+        if (dt < best) best = dt;
+    }
+    emit(name, items, iterations, best, total);
+}
+
+//! Loaders: cold = text parse (binary cache removed first), warm = cache hit
+static void drop_caches(void) {
+    remove(Users_Bin_Path);
+    remove(Votes_Bin_Path);
+    remove(Manifesto_Bin_Path);
+}
+static void bench_load_users(void) { User *u = NULL; load_users(&u); free(u); }
+static void bench_load_votes(void) { Vote *v = NULL; load_votes(&v); free(v); }
+static void bench_load_manifestos(void) { Manifesto *m = NULL; load_manifestos(&m); free(m); }
+
+static ElectionState st;
+static User *accounts; static int accountCount;
+static int authOk;
+
+static void bench_authenticate(void) {
+    User out;
+    for (int i = 0; i < accountCount; i++)
+        authOk += authenticate(&st.users, accounts[i].username, accounts[i].password, &out) != 0;
+}
+
+//! Students without a ballot, voted in one timed pass
+static User *pending; static int pendingCount;
+static void bench_record_votes(void) {
+    for (int i = 0; i < pendingCount; i++)
+        record_new_vote(&st, &pending[i], st.reps[i % st.repCount].username);
+    flush_vote_journal();
+}
+
+//! Publish folds the votes cast since the last publish: every iteration
+//! restores the results taken before record_new_vote, so each one folds
+//! the same pendingCount ballots instead of an empty delta
+static Manifesto *baseMfs; static int *baseCounts; static int baseCount, baseEpoch;
+static void snapshot_results(void) {
+    publish_results(&st);
+    state_refresh(&st);
+    baseCount = st.resCount;
+    baseEpoch = st.resEpoch;
+    baseMfs = malloc((baseCount ? baseCount : 1) * sizeof *baseMfs);
+    baseCounts = malloc((baseCount ? baseCount : 1) * sizeof *baseCounts);
+    if (!baseMfs || !baseCounts) return;
+    memcpy(baseMfs, st.resMfs, baseCount * sizeof *baseMfs);
+    memcpy(baseCounts, st.resCounts, baseCount * sizeof *baseCounts);
+}
+static void restore_results(void) {
+    if (baseMfs && baseCounts) save_results(baseMfs, baseCounts, baseCount, baseEpoch);
+    state_refresh(&st);
+}
+static void bench_publish(void) { publish_results(&st); }
+static void bench_sync(void) { sync_manifestos_with_users(st.reps, st.repCount); }
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <data-dir> [iterations]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2) iterations = atoi(argv[2]);
+    if (iterations < 1) iterations = 1;
+    if (chdir(argv[1]) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    //* keep the library's status lines out of the report
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    int devnull = open("/dev/null", O_WRONLY);
+    if (!report || devnull < 0) return 1;
+    fflush(stdout);
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+
+    accountCount = load_users_text(&accounts);
+    Vote *votes = NULL;
+    int voteCount = load_votes_text(&votes);
+    free(votes);
+    Manifesto *mfs = NULL;
+    int mfCount = load_manifestos_text(&mfs);
+    free(mfs);
+    if (accountCount <= 0) {
+        fprintf(stderr, "[ERROR] no users in %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(report, "{\"bench\":\"meta\",\"users\":%d,\"votes\":%d,\"iterations\":%d}\n",
+            accountCount, voteCount, iterations);
+
+    run("load_users_cold", accountCount, drop_caches, bench_load_users);
+    run("load_users_warm", accountCount, NULL, bench_load_users);
+    run("load_votes_cold", voteCount, drop_caches, bench_load_votes);
+    run("load_votes_warm", voteCount, NULL, bench_load_votes);
+    run("load_manifestos", mfCount, NULL, bench_load_manifestos);
+
+    if (state_load(&st) != 0 || st.repCount == 0) {
+        fprintf(stderr, "[ERROR] could not load the election state\n");
+        return 1;
+    }
+    run("authenticate", accountCount, NULL, bench_authenticate);
+
+    pending = malloc(accountCount * sizeof *pending);
+    for (int i = 0; pending && i < accountCount && pendingCount < 1000; i++)
+        if (accounts[i].role == ROLE_STUDENT && !state_has_voted(&st, accounts[i].username))
+            pending[pendingCount++] = accounts[i];
+    snapshot_results();
+    //* one pass only: a second one would hit "already voted"
+    int saved = iterations;
+    iterations = 1;
+    run("record_new_vote", pendingCount, NULL, bench_record_votes);
+    iterations = saved;
+
+    run("publish_results", pendingCount, restore_results, bench_publish);
+    run("sync_manifestos_with_users", st.repCount, NULL, bench_sync);
+
+    state_free(&st);
+    free(pending);
+    free(baseMfs);
+    free(baseCounts);
+    free(accounts);
+    fclose(report);
+    return 0;
+}
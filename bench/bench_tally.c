@@ -0,0 +1,74 @@
+// bench_tally.c — tally engine vs. the old nested strcmp loop
+//
+// Build from the repo root:
+//   gcc -O2 -Iinclude bench/bench_tally.c src/tally.c src/votelog.c src/intern.c src/nameindex.c -o bench_tally -lpthread
+//   or: cmake -S . -B build && cmake --build build --target bench_tally
+// Run:
+//   ./bench_tally [votes] [candidates]     (default 1000000 x 500)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tally.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//* The loop publish_results() used before the tally engine
+static void nested_tally(const Manifesto *mfs, int mfCount,
+                         const Vote *votes, int voteCount, int *counts) {
+    for (int i = 0; i < voteCount; i++) {
+        for (int j = 0; j < mfCount; j++) {
+            if (strcmp(votes[i].rep_username, mfs[j].rep_username) == 0) {
+                counts[j]++;
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int voteCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    int mfCount = argc > 2 ? atoi(argv[2]) : 500;
+
+    Manifesto *mfs = calloc(mfCount, sizeof *mfs);
+    Vote *votes = calloc(voteCount, sizeof *votes);
+    if (!mfs || !votes) { fprintf(stderr, "out of memory\n"); return 1; }
+
+    for (int j = 0; j < mfCount; j++)
+        snprintf(mfs[j].rep_username, USERNAME_LEN, "rep_%d", j);
+    srand(42);
+    for (int i = 0; i < voteCount; i++) {
+        snprintf(votes[i].student_username, USERNAME_LEN, "student_%d", i);
+        strcpy(votes[i].rep_username, mfs[rand() % mfCount].rep_username);
+    }
+
+    int *expected = calloc(mfCount, sizeof *expected);
+    double t0 = now_sec();
+    nested_tally(mfs, mfCount, votes, voteCount, expected);
+    double nested = now_sec() - t0;
+
+    t0 = now_sec();
+    Tally tally;
+    tally_init(&tally, mfCount);
+    for (int j = 0; j < mfCount; j++)
+        tally_add_candidate(&tally, mfs[j].rep_username);
+    tally_count_votes(&tally, votes, voteCount);
+    double engine = now_sec() - t0;
+
+    int mismatches = 0;
+    for (int j = 0; j < mfCount; j++)
+        if (tally_votes_for(&tally, mfs[j].rep_username) != expected[j]) mismatches++;
+
+    printf("votes=%d candidates=%d\n", voteCount, mfCount);
+    printf("nested strcmp loop : %8.3f s\n", nested);
+    printf("tally engine       : %8.3f s  (%.1fx)\n", engine, nested / engine);
+    printf("mismatches         : %d\n", mismatches);
+
+    tally_free(&tally);
+    free(expected); free(votes); free(mfs);
+    return mismatches != 0;
+}
@@ -0,0 +1,92 @@
+// bench_tally_parallel.c — parallel tally scaling from 1 to N threads,
+// over Vote records and over the interned id columns of a VoteLog
+//
+// Build from the repo root:
+//   gcc -O2 -Iinclude bench/bench_tally_parallel.c src/tally.c src/votelog.c src/intern.c src/nameindex.c -o bench_tally_parallel -lpthread
+//   or: cmake -S . -B build && cmake --build build --target bench_tally_parallel
+// Run:
+//   ./bench_tally_parallel [votes] [candidates] [max_threads]   (default 4000000 x 500 x online cores)
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "tally.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//* Fresh tally over the same candidates, counted with `threads` workers (0: serial path)
+static double timed_count(Tally *out, const Manifesto *mfs, int mfCount,
+                          const Vote *votes, int voteCount, int threads) {
+    tally_init(out, mfCount);
+    for (int j = 0; j < mfCount; j++)
+        tally_add_candidate(out, mfs[j].rep_username);
+    double t0 = now_sec();
+    if (threads == 0)
+        tally_count_votes(out, votes, voteCount);
+    else
+        tally_count_votes_parallel(out, votes, voteCount, threads);
+    return now_sec() - t0;
+}
+
+int main(int argc, char **argv) {
+    int voteCount = argc > 1 ? atoi(argv[1]) : 4000000;
+    int mfCount = argc > 2 ? atoi(argv[2]) : 500;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    Manifesto *mfs = calloc(mfCount, sizeof *mfs);
+    Vote *votes = calloc(voteCount, sizeof *votes);
+    if (!mfs || !votes) { fprintf(stderr, "out of memory\n"); return 1; }
+
+    for (int j = 0; j < mfCount; j++)
+        snprintf(mfs[j].rep_username, USERNAME_LEN, "rep_%d", j);
+    srand(42);
+    for (int i = 0; i < voteCount; i++) {
+        snprintf(votes[i].student_username, USERNAME_LEN, "student_%d", i);
+        strcpy(votes[i].rep_username, mfs[rand() % mfCount].rep_username);
+    }
+
+    Tally serial;
+    double base = timed_count(&serial, mfs, mfCount, votes, voteCount, 0);
+    printf("votes=%d candidates=%d\n", voteCount, mfCount);
+    printf("serial      : %8.3f s\n", base);
+
+    //* same votes as interned id columns (what ElectionState holds)
+    VoteLog log;
+    vote_log_init(&log, voteCount);
+    vote_log_append(&log, votes, voteCount);
+
+    int failures = 0;
+    //* 1, 2, 4, ... and finally maxThreads itself
+    for (int threads = 1; threads <= maxThreads;
+         threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        Tally par;
+        double t = timed_count(&par, mfs, mfCount, votes, voteCount, threads);
+        int same = memcmp(par.counts, serial.counts, mfCount * sizeof *par.counts) == 0;
+        if (!same) failures++;
+        printf("threads=%-3d : %8.3f s  (%.2fx)  %s\n", threads, t, base / t,
+               same ? "identical" : "MISMATCH");
+        tally_free(&par);
+
+        tally_init(&par, mfCount);
+        for (int j = 0; j < mfCount; j++)
+            tally_add_candidate(&par, mfs[j].rep_username);
+        double t0 = now_sec();
+        tally_count_log(&par, &log, 0, log.count, threads);
+        t = now_sec() - t0;
+        same = memcmp(par.counts, serial.counts, mfCount * sizeof *par.counts) == 0;
+        if (!same) failures++;
+        printf("  id columns: %8.3f s  (%.2fx)  %s\n", t, base / t, same ? "identical" : "MISMATCH");
+        tally_free(&par);
+    }
+
+    tally_free(&serial);
+    vote_log_free(&log);
+    free(votes); free(mfs);
+    return failures != 0;
+}
@@ -0,0 +1,116 @@
+// gen_election.c — deterministic synthetic election data for benchmarks
+//
+// Build from the repo root:
+//   gcc -O2 -Iinclude bench/gen_election.c -o gen_election
+//   or: cmake -S . -B build && cmake --build build --target gen_election
+// Run:
+//   ./gen_election <dir> [students] [reps] [votes] [manifesto_len] [seed]
+//   (default 100000 students, 50 reps, 80000 votes, 400-char manifestos, seed 1)
+//
+// Writes users.txt, manifestos.txt, votes.txt, results.txt and
+// votes_updates.txt into <dir> (which must exist), and removes the vote
+// journal, saved tallies and binary caches a previous run left there. The
+// same arguments always produce the same data directory.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include "models.h"
+
+static uint64_t rng_state;
+
+//* xorshift64*: tiny, fast and identical on every platform
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ull;
+}
+
+static FILE *open_in(const char *dir, const char *name) {
+    char path[512];
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+    FILE *f = fopen(path, "w");
+    if (!f) perror(path);
+    return f;
+}
+
+//* derived files would otherwise be replayed on top of the fresh data
+static int remove_in(const char *dir, const char *name) {
+    char path[512];
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+    if (remove(path) == 0 || errno == ENOENT) return 0;
+    perror(path);
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <dir> [students] [reps] [votes] [manifesto_len] [seed]\n", argv[0]);
+        return 1;
+    }
+    const char *dir = argv[1];
+    int students = argc > 2 ? atoi(argv[2]) : 100000;
+    int reps = argc > 3 ? atoi(argv[3]) : 50;
+    int votes = argc > 4 ? atoi(argv[4]) : 80000;
+    int mlen = argc > 5 ? atoi(argv[5]) : 400;
+    rng_state = argc > 6 ? strtoull(argv[6], NULL, 10) : 1;
+    if (rng_state == 0) rng_state = 1;
+    if (reps < 1) reps = 1;
+    if (votes > students) votes = students;
+    if (mlen < 1) mlen = 1;
+    if (mlen > MANIFESTO_LEN - 1) mlen = MANIFESTO_LEN - 1;
+
+    const char *derived[] = {Votes_Journal_Path, Tallies_Path, Users_Bin_Path,
+                             Votes_Bin_Path, Manifesto_Bin_Path};
+    for (size_t i = 0; i < sizeof derived / sizeof *derived; i++)
+        if (remove_in(dir, derived[i]) != 0) return 1;
+
+    FILE *users = open_in(dir, "users.txt");
+    FILE *mfs = open_in(dir, "manifestos.txt");
+    FILE *vts = open_in(dir, "votes.txt");
+    FILE *res = open_in(dir, "results.txt");
+    FILE *upd = open_in(dir, "votes_updates.txt");
+    int *order = malloc((students ? students : 1) * sizeof *order);
+    if (!users || !mfs || !vts || !res || !upd || !order) return 1;
+
+    //* users: default admin on top, then reps, then students
+    fprintf(users, "%s %s %d\n", INIT_ADMIN_USERNAME, INIT_ADMIN_PASSWORD, ROLE_ADMIN);
+    for (int r = 0; r < reps; r++)
+        fprintf(users, "rep%05d Rep_pass%d %d\n", r, r, ROLE_REP);
+    for (int s = 0; s < students; s++)
+        fprintf(users, "stu%07d Stu_pass%d %d\n", s, s, ROLE_STUDENT);
+
+    //* manifestos: words of 2-9 lowercase letters up to mlen characters
+    char text[MANIFESTO_LEN];
+    for (int r = 0; r < reps; r++) {
+        int n = 0;
+        while (n < mlen) {
+            int w = 2 + next_rand() % 8;
+            for (int k = 0; k < w && n < mlen; k++) text[n++] = 'a' + next_rand() % 26;
+            if (n < mlen) text[n++] = ' ';
+        }
+        text[n] = '\0';
+        fprintf(mfs, "rep%05d|%s\n", r, text);
+    }
+
+    //* votes: a random `votes` students, in random order; reps skewed so a
+    //* few candidates lead (index = reps * u^2, u uniform in [0, 1))
+    for (int s = 0; s < students; s++) order[s] = s;
+    for (int s = students - 1; s > 0; s--) {
+        int k = next_rand() % (s + 1);
+        int t = order[s]; order[s] = order[k]; order[k] = t;
+    }
+    for (int v = 0; v < votes; v++) {
+        double u = (next_rand() >> 11) * (1.0 / 9007199254740992.0);
+        fprintf(vts, "stu%07d rep%05d\n", order[v], (int)(reps * u * u));
+    }
+
+    fprintf(upd, "published 0\n");
+    fclose(users); fclose(mfs); fclose(vts); fclose(res); fclose(upd);
+    free(order);
+    printf("{\"students\":%d,\"reps\":%d,\"votes\":%d,\"manifesto_len\":%d}\n",
+           students, reps, votes, mlen);
+    return 0;
+}
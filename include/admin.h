@@ -1,11 +1,11 @@
 #ifndef ADMIN_H
 #define ADMIN_H
 #include "models.h"
+#include "state.h"
 
-void initial_admin_setup(void);
 int check_default_admin_at_top(void);
-int enforce_default_admin_top(void);
-int verify_and_clean_admins(void);
+int startup_integrity_pass(void);
 void admin_actions(void);
-void admin_menu(const User *current);
+void admin_menu(ElectionState *st, const User *current);
+int publish_results(const ElectionState *st);  //* returns the epoch published, -1 on failure
 #endif
@@ -0,0 +1,20 @@
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <stdio.h>
+
+// Whole-file rewrite that either fully replaces the target or leaves it untouched:
+// data goes to "<path>.tmp.<pid>", which is fsync'ed and renamed over `path`
+typedef struct {
+    FILE *f;            // write through this between open and commit
+    char path[256];
+    char tmp[272];
+    long long size;     // set by commit: size and mtime of the file now at `path`
+    long long mtime_ns;
+} AtomicFile;
+
+int atomic_file_open(AtomicFile *af, const char *path, const char *mode);   //* mode "w" or "wb"
+int atomic_file_commit(AtomicFile *af);     //* 0 once the new contents are durable, -1 on error
+void atomic_file_abort(AtomicFile *af);     //* drop the temp file, target untouched
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+#include "state.h"
+
+// Scripted use without menus; replies go to stdout, diagnostics to stderr
+//   election vote <student> <rep>         -> OK | ERR <reason>
+//   election publish                      -> OK <epoch> | ERR <reason>
+//   election tally [--json]               -> "<rep> <count>" lines, or one JSON object
+//   election convert tobin|totext users|votes|manifestos
+//   election batch                        -> line protocol on stdin, one reply per line:
+//     VOTE <student> <rep>   -> OK | ERR already-voted | ERR not-a-student | ERR not-a-candidate | ERR storage
+//     VOTED <student>        -> YES | NO
+//     LOGIN <user> <pass>    -> OK <role> | ERR credentials
+//     PUBLISH                -> OK <epoch> | ERR storage
+//     TALLY [JSON]           -> "<rep> <count>" lines then END, or one JSON line
+//     PING                   -> PONG
+//     QUIT                   -> stops reading
+bool batch_is_command(const char *name);
+void batch_begin(void);  //* call first: keeps stdout for replies, sends everything else to stderr
+int batch_run(ElectionState *st, int argc, char **argv);  //* argv[0] is the command; returns the exit code
+
+#endif
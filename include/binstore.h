@@ -0,0 +1,44 @@
+#ifndef BINSTORE_H
+#define BINSTORE_H
+
+#include <stdint.h>
+#include "models.h"
+
+#define BIN_MAGIC "SESB"
+#define BIN_FORMAT_VERSION 1
+
+typedef enum {
+    BIN_USERS = 1,
+    BIN_VOTES,
+    BIN_MANIFESTOS
+} BinKind;
+
+// File header, followed by `record_count` raw User/Vote/Manifesto records
+typedef struct {
+    char magic[4];          // BIN_MAGIC
+    uint32_t version;       // BIN_FORMAT_VERSION
+    uint32_t kind;          // BinKind
+    uint32_t record_size;   // sizeof the record struct when written
+    uint32_t record_count;
+    uint32_t checksum;      // FNV-1a over the record bytes
+    int64_t src_size;       // size of the text file this snapshot mirrors
+    int64_t src_mtime_ns;   // its modification time, in nanoseconds
+} BinHeader;
+
+// Identity of the text file a snapshot mirrors, as it was when it was read
+typedef struct {
+    int64_t size;
+    int64_t mtime_ns;
+} BinStamp;
+
+int bin_stamp(const char *src_path, BinStamp *out);  //* -1 if the file cannot be stat'ed
+// Binary snapshot of `records`; `src` identifies the text they were read from (NULL: none)
+int bin_save(const char *path, BinKind kind, const void *records, int count, const BinStamp *src);
+// Returns record count, or -1 if missing, corrupt, or stale w.r.t. `src_path` (NULL: skip check)
+int bin_load(const char *path, BinKind kind, void **out, const char *src_path);
+
+// Converters between the text files and their binary snapshots
+int bin_convert_from_text(BinKind kind);
+int bin_convert_to_text(BinKind kind);
+
+#endif
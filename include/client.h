@@ -0,0 +1,14 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <stdbool.h>
+#include "models.h"
+
+// Thin client for the vote daemon (see server.h); one connection per request
+bool client_detect(const char *sock_path);  //* true if a daemon answers
+bool client_active(void);
+int client_login(const char *username, const char *password, User *outUser);
+int client_has_voted(const char *student);
+int client_vote(const char *student, const char *rep);
+
+#endif
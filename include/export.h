@@ -0,0 +1,16 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stdio.h>
+
+typedef enum {
+    EXPORT_CSV = 0,
+    EXPORT_JSON
+} ExportFormat;
+
+// Results and per-candidate turnout, streamed from the data files: memory is
+// bounded by the number of candidates, never by the number of votes
+int export_results(FILE *out, ExportFormat fmt);
+int export_command(int argc, char **argv);  //* `election export csv|json [file]`; returns the exit code
+
+#endif
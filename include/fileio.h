@@ -1,15 +1,22 @@
 #ifndef FILEIO_H
 #define FILEIO_H
 
+#include <stddef.h>
 #include "models.h"
+#include "tally.h"
 
 // create files if they don't exist
 void ensure_file_exists(const char *fname);
 
+// Exclusive lock on the data directory (election.lock) shared by every running instance
+int storage_lock(void);        //* blocks; returns a handle for storage_unlock(), -1 on error
+void storage_unlock(int lock);
+
 // User storage in users.txt: each line "username password role"
 int load_users(User **out);
 int load_reps(User **outReps);  //* Load only representatives
 int save_users(const User *arr, int count);
+int append_user(const User *u);  //* add one line without rewriting the file
 
 // Manifesto in manifestos.txt: lines "rep_username|manifesto_text"
 int load_manifestos(Manifesto **out);
@@ -19,20 +26,46 @@ int save_manifestos(const Manifesto *arr, int count);
 int load_votes(Vote **out);
 int save_votes(const Vote *arr, int count);
 
-// Results in results.txt: "rep_username vote_count"
-int save_results(const Manifesto *mfs, const int *counts, int mfCount);
-int load_results(Manifesto **outMfs, int **outCounts);
+// Vote journal in votes_journal.txt: same line format, appended once per ballot
+int append_vote(const Vote *v);
+int append_votes(const Vote *arr, int count);  //* group commit: one write burst, one fsync
+int load_journal_tail(long long *offset, Vote **out);  //* ballots appended after *offset
+void flush_vote_journal(void);  //* fsync + close the journal (call before exit)
+int compact_votes(void);        //* fold the journal back into votes.txt
+
+// results.txt: "#epoch N" (votes the counts cover) then "rep_username count" lines
+int save_results(const Manifesto *mfs, const int *counts, int mfCount, int epoch);
+int load_results(Manifesto **outMfs, int **outCounts, int *outEpoch);
+
+// Text-only parsers: bypass the binary cache (and, for votes, the journal)
+int load_users_text(User **out);
+int load_manifestos_text(Manifesto **out);
+int load_votes_text(Vote **out);
+
+// Streaming scans: one record at a time, memory independent of the file size.
+// A visitor returns non-zero to stop the scan early.
+typedef int (*UserVisitor)(const User *u, void *ctx);
+typedef int (*VoteVisitor)(const Vote *v, void *ctx);
+int scan_users(UserVisitor fn, void *ctx);  //* same parser as load_users_text()
+int scan_votes(VoteVisitor fn, void *ctx);  //* snapshot + journal, same parser as load_votes()
+
+// Live tallies in tallies.txt: "#votes N last_student" then "rep_username count"
+// lines; the counts cover the first N votes of the vote log
+int save_tallies(const Tally *t, const VoteLog *log);
+int load_tallies(Tally *t, const VoteLog *log);
 
 // sync manifestos with representatives
-void sync_manifestos_with_reps(void);
+void sync_manifestos_with_users(const User *users, int count);
 
-//! Display the current status of the election results
-void display_result_status(void);
+//! Publish status: the vote epoch (ballot count) against the published epoch
+void display_result_status(int voteEpoch, int publishedEpoch);
 
-//! Mark the election results as published
-void mark_results_published(void);
+//! Published epoch in votes_updates.txt: "published N"
+int load_published_epoch(void);
+int save_published_epoch(int epoch);
+int migrate_vote_updates(void);     //* old "updated"/"vote_cast_by:" file -> epoch
 
-//! Append a vote update to the results file
-void append_vote_update(const User *current);
+//! Mark the election results as published
+int mark_results_published(int epoch);
 
 #endif
@@ -0,0 +1,7 @@
+#ifndef IMPORT_H
+#define IMPORT_H
+
+// Bulk import of a "username,password,role" CSV roster (role: student|rep)
+int import_roster(const char *csv_path);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+// Merge an offline ballot file ("student rep" lines) into the vote log
+int ingest_ballots(const char *path, int nthreads);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdint.h>
+#include "nameindex.h"
+
+// String interning table: each distinct username gets a dense id 0..count-1
+typedef struct {
+    NameIndex ids;                 // username -> id
+    char (*names)[USERNAME_LEN];   // id -> username
+    int count;
+    int cap;
+} Interner;
+
+int intern_init(Interner *in, int expected);
+int intern_id(Interner *in, const char *name);         // adds unseen names; -1 on error
+int intern_find(const Interner *in, const char *name); // -1 if never interned
+const char *intern_name(const Interner *in, uint32_t id);
+void intern_free(Interner *in);
+
+#endif
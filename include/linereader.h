@@ -0,0 +1,36 @@
+#ifndef LINEREADER_H
+#define LINEREADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LINE_READER_BLOCK (1 << 20)   // bytes per read()
+
+// One whitespace-separated field of a line (not null-terminated)
+typedef struct {
+    const char *p;
+    size_t len;
+} Field;
+
+// Block-buffered text reader: one read() per LINE_READER_BLOCK bytes, lines
+// handed out in place (no copy, no stdio, no locale)
+typedef struct {
+    int fd;
+    char *buf;
+    size_t cap, len, pos;   // buffer size, bytes held, start of the next line
+    long long base;         // file offset of buf[0]
+    int lineNo;             // 1-based number of the line last returned
+    bool eof;
+} LineReader;
+
+int line_reader_open(LineReader *r, const char *path);            //* -1 if it cannot be opened
+int line_reader_open_at(LineReader *r, const char *path, long long offset);  //* start mid-file
+long long line_reader_offset(const LineReader *r);               //* file offset of the next line
+const char *line_reader_next(LineReader *r, size_t *len);         //* NULL at end of file
+void line_reader_close(LineReader *r);
+
+int line_fields(const char *line, size_t len, Field *out, int max);  //* number of fields, up to max + 1
+int field_int(Field f, int *out);                                    //* 0, or -1 if not a decimal int
+int field_copy(Field f, char *dst, size_t size);                     //* 0, or -1 if it does not fit
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef MAPVIEW_H
+#define MAPVIEW_H
+
+#include <stddef.h>
+
+// Read-only memory-mapped text file with an index of line start offsets
+typedef struct {
+    const char *data;   // mapped file contents (NULL for an empty file)
+    size_t size;
+    size_t *line_off;   // start offset of every non-empty line
+    int *line_no;       // its 1-based line number in the file (blank lines count)
+    int lines;
+} MapView;
+
+int map_view_open(MapView *v, const char *path);
+const char *map_view_line(const MapView *v, int i, size_t *len);
+const char *map_view_field(const char *line, size_t len, int n, size_t *flen);
+void map_view_close(MapView *v);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "models.h"
+
+// Instrumented operations; metric_names[] in metrics.c follows this order
+typedef enum {
+    MET_LOAD_USERS = 0,
+    MET_LOAD_MANIFESTOS,
+    MET_LOAD_VOTES,
+    MET_LOAD_RESULTS,
+    MET_SAVE_USERS,
+    MET_SAVE_MANIFESTOS,
+    MET_SAVE_VOTES,
+    MET_SAVE_RESULTS,
+    MET_JOURNAL_APPEND,
+    MET_AUTHENTICATE,
+    MET_RECORD_VOTE,
+    MET_PUBLISH,
+    MET_OP_COUNT
+} MetricOp;
+
+// Latency buckets: upper bounds 1us, 4us, 16us ... 4^(n-2) us, then +Inf
+#define METRICS_BUCKETS 12
+
+#if ENABLE_METRICS
+
+uint64_t metrics_clock(void);  //* monotonic nanoseconds
+void metrics_record(MetricOp op, uint64_t ns);
+void metrics_add_read(uint64_t bytes);
+void metrics_add_written(uint64_t bytes);
+
+//* time a block: METRIC_START(t); ... METRIC_STOP(MET_X, t);
+#define METRIC_START(var) uint64_t var = metrics_clock()
+#define METRIC_STOP(op, var) metrics_record((op), metrics_clock() - (var))
+#define METRIC_READ(n) metrics_add_read((uint64_t)(n))
+#define METRIC_WRITTEN(n) metrics_add_written((uint64_t)(n))
+
+#else
+
+#define METRIC_START(var) ((void)0)
+#define METRIC_STOP(op, var) ((void)0)
+#define METRIC_READ(n) ((void)0)
+#define METRIC_WRITTEN(n) ((void)0)
+
+#endif
+
+// Always available; they report that metrics are off when compiled out
+void metrics_print(FILE *out);               //* human-readable table
+const char *metrics_path(void);              //* this process's file, from Metrics_Path_Format
+void metrics_finish(void);                   //* remove metrics_path() at exit
+int metrics_write_prometheus(const char *path);  //* text exposition format, atomic rewrite
+void metrics_maybe_flush(void);              //* write metrics_path() every METRICS_FLUSH_SECONDS
+
+#endif
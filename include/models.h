@@ -6,12 +6,33 @@
 #define MANIFESTO_LEN 512
 #define INIT_ADMIN_USERNAME "SCDS"
 #define INIT_ADMIN_PASSWORD "202504"
+#define VOTE_JOURNAL_SYNC_EVERY 32 // fsync the vote journal once per this many ballots
+#define VOTE_JOURNAL_COMPACT_BYTES (1 << 20) // publish folds the journal into votes.txt past this size
+#define TALLY_THREADS 0 // full recounts: worker threads (0 = one per online core)
+#define TALLY_PARALLEL_MIN 65536 // fewer votes than this are counted on the calling thread
 
 #define Manifesto_Path "manifestos.txt"
 #define Users_Path "users.txt"
 #define Votes_Path "votes.txt"
+#define Votes_Journal_Path "votes_journal.txt"
 #define Results_Path "results.txt"
 #define Vote_Updates_Path "votes_updates.txt"
+#define Tallies_Path "tallies.txt"
+#define Lock_Path "election.lock"
+#define Server_Socket_Path "election.sock"
+
+// Binary snapshots of the text files (see binstore.h); set to 0 to keep text only
+#define USE_BINARY_CACHE 1
+#define Users_Bin_Path "users.bin"
+#define Votes_Bin_Path "votes.bin"
+#define Manifesto_Bin_Path "manifestos.bin"
+
+// Operation counters and latency histograms (see metrics.h); 0 compiles them out
+#ifndef ENABLE_METRICS
+#define ENABLE_METRICS 1
+#endif
+#define Metrics_Path_Format "metrics.%ld.prom" // one file per process, filled with its pid
+#define METRICS_FLUSH_SECONDS 10 // rewrite the metrics file at most this often
 
 typedef enum {
     ROLE_ADMIN = 0,
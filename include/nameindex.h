@@ -0,0 +1,32 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <stddef.h>
+#include "models.h"
+
+// Open-addressing hash table mapping a username to an int (array position, id...)
+typedef struct {
+    char (*keys)[USERNAME_LEN];  // zero-padded to USERNAME_LEN bytes; "" marks an empty slot
+    int *values;
+    int cap;                     // number of slots, always a power of two
+    int count;                   // number of stored keys
+} NameIndex;
+
+// Fixed-width (USERNAME_LEN byte) compare/hash kernels, picked at runtime from the CPU
+typedef enum {
+    NAME_KERNEL_AUTO = 0,
+    NAME_KERNEL_SCALAR,   // 64-bit words
+    NAME_KERNEL_SSE2,     // 2 x 16-byte compares
+    NAME_KERNEL_AVX2      // 1 x 32-byte compare, SSE4.2 crc32 hash
+} NameIndexKernel;
+
+int name_index_use_kernel(NameIndexKernel k);  //* benchmarks only: call before building any index
+const char *name_index_kernel(void);
+
+int name_index_init(NameIndex *ix, int expected);
+int name_index_get(const NameIndex *ix, const char *name);       // -1 if absent
+int name_index_get_n(const NameIndex *ix, const char *name, size_t len);
+int name_index_put(NameIndex *ix, const char *name, int value);  // insert or overwrite
+void name_index_free(NameIndex *ix);
+
+#endif
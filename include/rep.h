@@ -2,9 +2,10 @@
 #define REP_H
 
 #include "models.h"
+#include "state.h"
 
 // Launch the menu for student representatives
 void Representative_actions();
-void rep_menu(const User *current);
+void rep_menu(ElectionState *st, const User *current);
 
 #endif
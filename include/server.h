@@ -0,0 +1,17 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "state.h"
+
+#define SERVER_QUEUE_LEN 256   // accepted connections waiting for a worker
+#define SERVER_BATCH_MAX 512   // ballots per group commit
+#define SERVER_IO_TIMEOUT_SECONDS 5  // a silent or stalled client frees its worker after this
+
+// Vote daemon: owns the state and serves one-line requests on a Unix socket
+//   LOGIN <user> <pass>   -> OK <role> | ERR credentials
+//   VOTED <student>       -> YES | NO
+//   VOTE <student> <rep>  -> OK | ERR already-voted | ERR not-a-student | ERR no-candidates | ERR not-a-candidate | ERR storage
+//   TALLY                 -> "<rep> <count>" lines, then END
+int server_run(ElectionState *st, const char *sock_path, int nthreads);
+
+#endif
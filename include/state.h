@@ -0,0 +1,50 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include <stdbool.h>
+#include "models.h"
+#include "userstore.h"
+#include "tally.h"
+#include "votelog.h"
+
+// Identity of a data file when it was last read or written by this process
+typedef struct {
+    long long size;
+    long long mtime_ns;
+    unsigned long long ino;
+} FileStamp;
+
+// Dirty sections waiting for state_commit()
+enum {
+    DIRTY_MANIFESTOS = 1 << 0
+};
+
+// Whole election held in memory for the lifetime of the program (owned by main)
+typedef struct {
+    UserStore users;
+    User *reps; int repCount;
+    Manifesto *mfs; int mfCount;
+    VoteLog log;                                       // every ballot, as interned ids
+    Manifesto *resMfs; int *resCounts; int resCount;  // last published results
+    int resEpoch;                                      // votes those counts cover (-1: unknown)
+    Tally tally;                                       // live vote count per rep
+    int publishedEpoch;                                // votes covered at the last publish
+    int dirty;                                         // DIRTY_* bits
+    FileStamp usersStamp, mfsStamp, votesStamp, journalStamp, resultsStamp, publishedStamp;
+    long long journalOffset;                           // journal bytes already in `log` (-1: unknown)
+} ElectionState;
+
+int state_load(ElectionState *st);
+void state_refresh(ElectionState *st);  //* reload only files changed on disk
+int state_add_user(ElectionState *st, const User *u);  //* 1 if the username is taken
+int state_add_vote(ElectionState *st, const Vote *v);  //* 1 if already voted, 2 if not a candidate
+int state_absorb_votes(ElectionState *st, const Vote *votes, int count);
+bool state_has_voted(const ElectionState *st, const char *student);
+int state_set_manifesto(ElectionState *st, const char *rep, const char *text);
+int state_commit(ElectionState *st);
+int state_checkpoint(ElectionState *st);    //* compact a large journal + save tallies
+int state_mark_published(ElectionState *st, int epoch);
+int state_verify_tally(ElectionState *st);  //* full recount check, repairs on mismatch
+void state_free(ElectionState *st);
+
+#endif
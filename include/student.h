@@ -2,9 +2,11 @@
 #define STUDENT_H
 
 #include "models.h"
+#include "state.h"
 
 // Launch the menu for students
 void students_actions();
-void student_menu(const User *current);
+void student_menu(ElectionState *st, const User *current);
+void record_new_vote(ElectionState *st, const User *current, const char *choice);
 
 #endif
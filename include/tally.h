@@ -0,0 +1,27 @@
+#ifndef TALLY_H
+#define TALLY_H
+
+#include "models.h"
+#include "nameindex.h"
+#include "votelog.h"
+
+// Vote counter: rep usernames are interned to dense ids, counts[id] holds the votes
+typedef struct {
+    NameIndex ids;                 // rep username -> candidate id
+    char (*names)[USERNAME_LEN];   // candidate id -> rep username
+    int *counts;                   // candidate id -> vote count
+    int count;                     // number of candidates
+    int cap;
+} Tally;
+
+int tally_init(Tally *t, int expected);
+int tally_add_candidate(Tally *t, const char *rep_username);  // returns the id, -1 on error
+void tally_count_votes(Tally *t, const Vote *votes, int voteCount);
+void tally_count_votes_parallel(Tally *t, const Vote *votes, int voteCount, int nthreads);  // 0: TALLY_THREADS
+void tally_count_log(Tally *t, const VoteLog *log, int first, int last, int nthreads);  // votes [first, last)
+void tally_count_rep(Tally *t, const char *rep, size_t len);  // one vote, rep not null-terminated
+int tally_votes_for(const Tally *t, const char *rep_username);
+int tally_verify(const Tally *t, const VoteLog *log);  // mismatching candidates
+void tally_free(Tally *t);
+
+#endif
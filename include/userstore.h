@@ -0,0 +1,20 @@
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include "models.h"
+#include "nameindex.h"
+
+// In-memory copy of users.txt with a username hash index, loaded once at startup
+typedef struct {
+    User *users;
+    int count;
+    int cap;
+    NameIndex index;  // username -> position in users[]
+} UserStore;
+
+int user_store_load(UserStore *s);
+const User *user_store_find(const UserStore *s, const char *uname);
+int user_store_add(UserStore *s, const User *u);  //* also appends to users.txt
+void user_store_free(UserStore *s);
+
+#endif
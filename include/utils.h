@@ -2,7 +2,9 @@
 #define UTILS_H
 
 #include "models.h"
+#include "userstore.h"
 #include <stdbool.h>
+#include <stdio.h>
 #include <ctype.h>
 
 // Prompts for menu selections with min/max return values
@@ -12,9 +14,9 @@ int rep_prompt();
 int student_prompt();
 int get_int(int min, int max);
 //! authentification
-int authenticate(const char *username, const char *password, User *outUser);
+int authenticate(const UserStore *store, const char *username, const char *password, User *outUser);
 //! Preventing Duplicate usernames 
-bool username_exists(User *users, int count, const char *uname);
+bool username_exists(const UserStore *store, const char *uname);
 //! Password
 bool is_strong_password(const char *p);
 void password_guideline();
@@ -28,5 +30,6 @@ void logging_out();
 
 // string formatting
 char *format_string(char *str);
+void json_print_string(FILE *out, const char *s);  //* quoted and escaped
 
 #endif
@@ -0,0 +1,25 @@
+#ifndef VOTELOG_H
+#define VOTELOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "models.h"
+#include "intern.h"
+
+// In-memory vote log as parallel id columns: 8 bytes per ballot instead of a
+// 64-byte Vote. The text files keep "student_username rep_username" lines.
+typedef struct {
+    Interner students, reps;   // usernames behind the ids below
+    uint32_t *student;         // vote i -> student id
+    uint32_t *rep;             // vote i -> rep id
+    int count, cap;            // votes held / allocated
+} VoteLog;
+
+int vote_log_init(VoteLog *log, int expected);
+int vote_log_append(VoteLog *log, const Vote *votes, int count);
+bool vote_log_has_voted(const VoteLog *log, const char *student);
+const char *vote_log_student(const VoteLog *log, int i);
+const char *vote_log_rep(const VoteLog *log, int i);
+void vote_log_free(VoteLog *log);
+
+#endif
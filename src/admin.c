@@ -4,48 +4,10 @@
 #include "admin.h"
 #include "fileio.h"
 #include "utils.h"
+#include "tally.h"
+#include "metrics.h"
 
 
-/**
- * ? Ensure an initial admin account is created on first run.
- *
- * If no users exist (count == 0 after loading), this function:
- *  - Prompts for creation of an admin account.
- *  - Uses predefined INIT_ADMIN_USERNAME and INIT_ADMIN_PASSWORD.
- *  - Allocates or reallocates the users array to length 1.
- *  - Saves the new user with role = ROLE_ADMIN.
- *
- * No parameters.
- * @return Nothing.
- *
- * *Usage:
- *  - Called at program startup.
- *  - Ensures there's always at least one admin.
- */
-void initial_admin_setup() {
-    User *users = NULL;
-    int count = load_users(&users);
-    if (count == 0) {
-        printf("\n=== Initial Admin Setup ===\n");
-        printf("Create Admin Account\n");
-        char uname[USERNAME_LEN], pass[PASS_LEN];
-
-        strncpy(uname, INIT_ADMIN_USERNAME, USERNAME_LEN);
-        strncpy(pass, INIT_ADMIN_PASSWORD, PASS_LEN);
-
-        users = realloc(users, sizeof(User));
-        strcpy(users[0].username, uname);
-        strcpy(users[0].password, pass);
-        users[0].role = ROLE_ADMIN;
-
-
-        save_users(users, 1);
-        free(users);
-
-        printf("[SUCCESS] Admin account initialized.\n\n");
-    }
-}
-
 /**
  * ? Check if the first line of the users file contains the default admin credentials.
  *
@@ -78,108 +40,82 @@ int check_default_admin_at_top(void) {
 }
 
 /**
- * ? Ensure default admin credentials are the first line in the users file.
+ * ? Apply the admin invariants to a user list in memory.
  *
- * If `check_default_admin_at_top()` returns 0, this function:
- *   - Reads all user entries,
- *   - Inserts the default admin record at the beginning,
- *   - Removes other admin-role (0) users,
- *   - Writes the updated list back to `Users_Path`.
+ * The result holds the default admin ("SCDS", "202504", role 0) first,
+ * followed by every non-admin user in file order; any other admin entry,
+ * including a default admin with a wrong password or position, is dropped.
  *
- * * Usage:
- *   - Called during login and registration to ensure the default admin is always present.
- * @return `0` on success, `-1` on I/O or memory errors.
- *
- * @note Uses dynamic reloading of users via load_users() and save_users().
+ * @param users  Users as loaded from disk.
+ * @param count  Number of entries.
+ * @param out    Receives `count + 1` entries at most (caller-allocated).
+ * @param outCount  Receives the number of entries written to `out`.
+ * @return `1` if `out` differs from `users`, `0` if the list was already clean.
  */
-int enforce_default_admin_top(void) {
-    if (check_default_admin_at_top()) return 0;
-
-    User *users = NULL;
-    int count = load_users(&users);
-
-    if (!users && count > 0) return -1;
-
-    User *filtered = malloc((count + 1) * sizeof *filtered);
-    if (!filtered) { free(users); return -1; }
-
-    // Insert default admin first
-    strcpy(filtered[0].username, "SCDS");
-    strcpy(filtered[0].password, "202504");
-    filtered[0].role = 0;
-
-    int idx = 1;
-    for (int i = 0; i < count; i++) {
-        if (!(users[i].role == 0 &&
-                strcmp(users[i].username, "SCDS") != 0)) {
-            filtered[idx++] = users[i];
-        }
-    }
-
-    int result = save_users(filtered, idx);
-    free(users);
-    free(filtered);
-    return result;
+static int clean_admins(const User *users, int count, User *out, int *outCount) {
+    memset(&out[0], 0, sizeof out[0]);
+    strcpy(out[0].username, INIT_ADMIN_USERNAME);
+    strcpy(out[0].password, INIT_ADMIN_PASSWORD);
+    out[0].role = ROLE_ADMIN;
+
+    int keep = 1;
+    for (int i = 0; i < count; i++)
+        if (users[i].role != ROLE_ADMIN)
+            out[keep++] = users[i];
+    *outCount = keep;
+
+    //* only the first line may be an admin, and it must be the default one
+    return keep != count ||
+           strcmp(users[0].username, INIT_ADMIN_USERNAME) != 0 ||
+           strcmp(users[0].password, INIT_ADMIN_PASSWORD) != 0 ||
+           users[0].role != ROLE_ADMIN;
 }
 
 /**
- * ? Ensure only one genuine default admin exists and is correctly positioned.
+ * ? Validate the users and manifesto files once at startup.
  *
- * 1. If the first line doesn't match the default admin, call enforce_default_admin_top()
- *    to insert or fix it at the top.
- * 2. Load all users.
- * 3. Filter the list:
- *      • Keep exactly one correct default admin ("SCDS", "202504", role 0),
- *      • Include all non-admin users,
- *      • Discard any extra/invalid admins.
- * 4. Save the updated list back to disk.
+ * users.txt is loaded a single time under the storage lock, the admin
+ * invariants (see clean_admins()) are applied in memory, and users.txt is
+ * rewritten only if they did not hold; an empty file gets the default
+ * admin. The manifesto sync then works from the same list.
  *
  * @return 0 on success; -1 on failure (I/O or memory error).
+ *
+ * * Usage:
+ *   - Called once by main() before the election state is loaded.
  */
-int verify_and_clean_admins(void) {
-    // Step 1: Ensure default admin is at the top
-    if (!check_default_admin_at_top()) {
-        if (enforce_default_admin_top() != 0) {
-            return -1;
-        }
-    }
-
-    // Step 2: Load all users
+int startup_integrity_pass(void) {
+    int lock = storage_lock();
+    if (lock < 0) return -1;
     User *users = NULL;
     int count = load_users(&users);
-    if (!users && count > 0) {
-        return -1;
-    }
-
-    // Step 3: Filter users
-    User *filtered = malloc(count * sizeof *filtered);
-    if (!filtered) {
+    User *clean = malloc((count + 1) * sizeof *clean);
+    if (!clean || (!users && count > 0)) {
         free(users);
+        free(clean);
+        storage_unlock(lock);
         return -1;
     }
 
     int keep = 0;
-    bool keptAdmin = false;
-
-    for (int i = 0; i < count; i++) {
-        if (users[i].role == 0) {
-            if (!keptAdmin
-                && strcmp(users[i].username, "SCDS") == 0
-                && strcmp(users[i].password, "202504") == 0) {
-                filtered[keep++] = users[i];
-                keptAdmin = true;
-            }
-            // else skip extra admin entries
+    int result = 0;
+    if (clean_admins(users, count, clean, &keep)) {
+        if (count == 0) {
+            printf("\n=== Initial Admin Setup ===\n");
+            printf("Create Admin Account\n");
         } else {
-            filtered[keep++] = users[i];
+            printf("\n[WARNING] Users file failed the admin checks; repairing it.\n");
         }
+        result = save_users(clean, keep);
+        if (result == 0)
+            printf(count == 0 ? "[SUCCESS] Admin account initialized.\n\n"
+                              : "[SUCCESS] Default admin is now the only admin, at the top of the users file.\n");
     }
+    sync_manifestos_with_users(clean, keep);
 
     free(users);
-
-    // Step 4: Save filtered list
-    int result = save_users(filtered, keep);
-    free(filtered);
+    free(clean);
+    storage_unlock(lock);
     return result;
 }
 
@@ -187,132 +123,154 @@ void admin_actions(){
     printf("\nAs an admin you can:\n");
     printf("  • View a list of registered student representatives.\n");
     printf("  • View the total number of votes each representative has received.\n");
-    printf("  • Publish and display the final election results.\n\n");
+    printf("  • Publish and display the final election results.\n");
+    printf("  • Verify the live vote counts against a full recount.\n");
+    printf("  • Show operation counts and timings (also written to %s).\n\n", metrics_path());
 }
 
 /**
  * ? List all registered student representatives.
  *
- * Loads representatives and displays their usernames. If none are found,
- * prints a warning and returns 0; otherwise prints count and returns repCount.
+ * Prints the reps held in the election state (no file access). If none
+ * are found, prints a warning and returns 0; otherwise returns repCount.
  *
+ * @param st  Current election state.
  * @return The number of representatives (0 if none found).
  *
  * * Usage:
  *  - Called when admin selects "list representatives".
  *  - Helps admins verify which reps are registered.
  */
-int Student_rep_list(void) {
-    User *reps = NULL;
-    int repCount = load_reps(&reps);  // load only reps
-
-    if (repCount == 0) {
+int Student_rep_list(const ElectionState *st) {
+    if (st->repCount == 0) {
         printf("\n[WARNING] No registered student representatives found.\n");
         return 0;
     }
-    else {
-        printf("\n[SUCCESS] Representatives loaded successfully.\n");
-        printf("=================================================\n\n");
-        printf("Registered Student Representatives:\n");
-        for (int i = 0; i < repCount; i++) {
-            printf("  • %s\n", reps[i].username);
-        }
+    printf("\n[SUCCESS] Representatives loaded successfully.\n");
+    printf("=================================================\n\n");
+    printf("Registered Student Representatives:\n");
+    for (int i = 0; i < st->repCount; i++) {
+        printf("  • %s\n", st->reps[i].username);
     }
-
-    free(reps);
-    return repCount;
+    return st->repCount;
 }
 
 /**
  * ? Display the current vote count for each representative.
  *
- * Loads all reps and all votes, then:
+ * Reads the live tally kept in the election state:
  *  - If no reps exist: warns and exits.
  *  - Calculates max username length to align output.
- *  - Counts votes per rep and displays formatted results.
+ *  - Displays each rep's vote count.
+ *
+ * @param st  Current election state.
  *
  * * Usage:
  *  - Called when admin selects "view votes".
  *  - Provides a snapshot of ongoing vote tallies.
  */
-void Display_votes(void) {
-    User *reps = NULL;
-    int repCount = load_reps(&reps);
-
-    Vote *votes = NULL;
-    int voteCount = load_votes(&votes);
+void Display_votes(const ElectionState *st) {
+    const Tally *tally = &st->tally;
 
     printf("\n\nCurrent vote counts:\n");
-    if (repCount == 0) {
+    if (tally->count == 0) {
         printf("[WARNING] No representatives found.\n");
-        free(reps); free(votes);
         return;
     }
 
     int maxNameLen = 0;
-    for (int i = 0; i < repCount; i++)
-        if ((int)strlen(reps[i].username) > maxNameLen)
-            maxNameLen = strlen(reps[i].username);
-
-    for (int i = 0; i < repCount; i++) {
-        int cnt = 0;
-        for (int j = 0; j < voteCount; j++)
-            if (strcmp(votes[j].rep_username, reps[i].username) == 0)
-                cnt++;
+    for (int i = 0; i < tally->count; i++)
+        if ((int)strlen(tally->names[i]) > maxNameLen)
+            maxNameLen = strlen(tally->names[i]);
 
+    for (int i = 0; i < tally->count; i++) {
         printf(" • %-*s : %*d votes\n",
                 maxNameLen,
-                reps[i].username,
+                tally->names[i],
                4,  // lets assume vote counts won't exceed 9999
-                cnt);
+                tally->counts[i]);
     }
-
-    free(reps); free(votes);
 }
 
 
 /**
- * ? Tally votes and publish election results.
+ * ? Publish election results incrementally.
  *
- * @param mfs       Array of manifestos (one per candidate).
- * @param mfCount   Number of manifestos.
- * @param votes     Array of all votes cast.
- * @param voteCount Total number of votes.
+ * @param st  Current election state.
+ * @return    Number of votes the published results cover; -1 on failure.
  *
  * This function:
- *  - Allocates an integer tally array (initialized to zero).
- *  - Increments the count when `votes[i].rep_username` matches `mfs[j].rep_username`.
- *  - Saves results via save_results().
+ *  - Starts from the counts in results.txt, which cover the first
+ *    `st->resEpoch` votes of the log, and counts only the votes cast
+ *    since (O(candidates + new votes), independent of total turnout).
+ *  - Falls back to the live tally when results.txt has no epoch
+ *    (nothing published yet, or a file from an older version).
+ *  - Saves results via save_results(), tagged with the new epoch.
  *  - Prints success or error on memory failure.
  *
  * * Usage:
  *  - Called when admin chooses to publish results (opt == 3).
  *  - Outputs final vote counts to storage and informs the admin.
  */
-void publish_results(Manifesto *mfs, int mfCount, Vote *votes, int voteCount) {
-    int *counts = calloc(mfCount, sizeof *counts);
-    if (!counts) {
+int publish_results(const ElectionState *st) {
+    METRIC_START(t);
+    int epoch = st->log.count;
+    int *counts = calloc(st->mfCount ? st->mfCount : 1, sizeof *counts);
+    Tally delta = {0};
+    bool fold = st->resEpoch >= 0 && st->resEpoch <= epoch;
+    if (!counts || (fold && tally_init(&delta, st->mfCount) != 0)) {
         fprintf(stderr, "[ERROR] Out of memory during tally.\n");
-        return;
+        free(counts);
+        return -1;
     }
 
-    for (int i = 0; i < voteCount; i++) {
-        for (int j = 0; j < mfCount; j++) {
-            if (strcmp(votes[i].rep_username, mfs[j].rep_username) == 0) {
-                counts[j]++;
-                break;  // Found the candidate; no need to check further
-            }
+    if (fold) {
+        for (int j = 0; j < st->mfCount; j++)
+            tally_add_candidate(&delta, st->mfs[j].rep_username);
+        //* seed with the published counts, then add the votes since
+        for (int i = 0; i < st->resCount; i++) {
+            int id = name_index_get(&delta.ids, st->resMfs[i].rep_username);
+            if (id >= 0) delta.counts[id] = st->resCounts[i];
         }
+        tally_count_log(&delta, &st->log, st->resEpoch, epoch, 0);
     }
-
-    save_results(mfs, counts, mfCount);
-    printf("\n[SUCCESS] Results published.\n");
+    for (int j = 0; j < st->mfCount; j++)
+        counts[j] = tally_votes_for(fold ? &delta : &st->tally, st->mfs[j].rep_username);
+
+    int result = save_results(st->mfs, counts, st->mfCount, epoch);
+    if (result == 0)
+        printf("\n[SUCCESS] Results published (%d new vote(s) since the last publish).\n",
+               fold ? epoch - st->resEpoch : epoch);
+    else
+        fprintf(stderr, "[ERROR] Could not write the results file.\n");
+    tally_free(&delta);
     free(counts);
+    METRIC_STOP(MET_PUBLISH, t);
+    return result == 0 ? epoch : -1;
+}
+
+/**
+ * ? Check the live tally against a full recount.
+ *
+ * Prints whether the running counters match; any mismatch is repaired
+ * by state_verify_tally().
+ *
+ * @param st  Current election state.
+ */
+void verify_tallies(ElectionState *st) {
+    int mismatches = state_verify_tally(st);
+    if (mismatches == 0)
+        printf("\n[SUCCESS] Live tallies match a full recount of %d votes.\n", st->log.count);
+    else if (mismatches > 0)
+        printf("\n[WARNING] %d candidate count(s) were off and have been recounted.\n", mismatches);
+    else
+        fprintf(stderr, "[ERROR] Out of memory during tally.\n");
 }
 
 /**
  * ? Admin-level interactive menu loop.
  *
+ * @param st       Election state owned by main().
  * @param current  Pointer to the currently logged-in admin User.
  *
  * ! Displays a welcome banner, shows available actions, and enters a loop that:
@@ -321,14 +279,17 @@ void publish_results(Manifesto *mfs, int mfCount, Vote *votes, int voteCount) {
  *  3. On '1': lists reps.
  *  4. On '2': displays vote counts.
  *  5. On '3': publishes results, marks them published, and displays status.
- *  6. On invalid choice: prints error and repeats.
- * Loads and frees manifestos and votes for options 1–3.
+ *  6. On '4': checks the live tallies against a full recount.
+ *  7. On '5': prints the metrics and rewrites the metrics file.
+ *  8. On invalid choice: prints error and repeats.
+ * Works from the in-memory state; files are only re-read when
+ * state_refresh() sees they changed on disk.
  *
  * * Usage:
  *  - Called once admin successfully logs in.
  *  - Drives all high-level admin interactions until logout.
  */
-void admin_menu(const User *current) {
+void admin_menu(ElectionState *st, const User *current) {
     printf("\n=================================");
     printf("\n      [Welcome] Admin: %s\n", current->username);
     printf("=================================\n");
@@ -343,31 +304,39 @@ void admin_menu(const User *current) {
             logging_out();
             break;
         }
-        Manifesto *mfs; int mfCount = load_manifestos(&mfs);
-        Vote *votes; int voteCount = load_votes(&votes);
+        state_refresh(st);
 
         //! Rep list
         if (opt == 1) {
-            Student_rep_list();
+            Student_rep_list(st);
         } 
         //! vote count
         else if (opt == 2) {
-            Display_votes();
+            Display_votes(st);
         }
         //! publish results 
         else if (opt == 3 && 
                 (check_default_admin_at_top() == 1)) {
-            publish_results(mfs, mfCount, votes, voteCount);
+            int epoch = publish_results(st);
+            // Checkpoint: save tallies, compact the vote journal if large
+            state_checkpoint(st);
             // Mark results as published
-            mark_results_published();
+            if (epoch >= 0) state_mark_published(st, epoch);
             // Display the status of results
-            display_result_status();
-    } else {
-        printf("[Error] Invalid option. Please try again.\n");
-        continue;
-    }
-    // Cleanup
-        free(mfs);
-        free(votes);
+            display_result_status(st->log.count, st->publishedEpoch);
+        }
+        //! verify live tallies
+        else if (opt == 4) {
+            verify_tallies(st);
+        }
+        //! operation counters and latencies
+        else if (opt == 5) {
+            printf("=================================================\n");
+            metrics_print(stdout);
+            if (metrics_write_prometheus(metrics_path()) == 0)
+                printf("[SUCCESS] Metrics written to %s.\n", metrics_path());
+        } else {
+            printf("[Error] Invalid option. Please try again.\n");
+        }
     }
 }
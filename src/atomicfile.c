@@ -0,0 +1,92 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "atomicfile.h"
+#include "metrics.h"
+
+/**
+ * ? Start rewriting a file atomically.
+ *
+ * Opens a temp file next to `path` (same directory, so the final rename
+ * never crosses a filesystem). Readers keep seeing the old contents until
+ * atomic_file_commit() succeeds.
+ *
+ * @param af    Handle to fill; write through `af->f`.
+ * @param path  File to replace.
+ * @param mode  fopen() mode for the temp file ("w" or "wb").
+ * @return      0 on success; -1 if the temp file cannot be created.
+ *
+ * @note Every successful open must end in atomic_file_commit() or
+ *       atomic_file_abort().
+ */
+int atomic_file_open(AtomicFile *af, const char *path, const char *mode) {
+    af->f = NULL;
+    if (snprintf(af->path, sizeof af->path, "%s", path) >= (int)sizeof af->path) return -1;
+    snprintf(af->tmp, sizeof af->tmp, "%s.tmp.%ld", path, (long)getpid());
+    af->f = fopen(af->tmp, mode);
+    return af->f ? 0 : -1;
+}
+
+/**
+ * ? fsync the directory holding `path`, making a rename in it durable.
+ */
+static int sync_parent_dir(const char *path) {
+    char dir[256];
+    const char *slash = strrchr(path, '/');
+    if (!slash) {
+        strcpy(dir, ".");
+    } else {
+        size_t len = slash == path ? 1 : (size_t)(slash - path);
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return -1;
+    int rc = fsync(fd);
+    close(fd);
+    return rc;
+}
+
+/**
+ * ? Make the new contents durable and swap them in.
+ *
+ * Flushes and fsyncs the temp file, renames it over the target (atomic on
+ * POSIX: a crash leaves either the old or the new file, never a truncated
+ * one), then fsyncs the directory so the rename itself survives a crash.
+ * `af->size` / `af->mtime_ns` then identify the new file, taken from the
+ * written descriptor itself (a stat of `path` could see a later writer).
+ *
+ * @param af  Handle from atomic_file_open().
+ * @return    0 on success; -1 on any failure, in which case the temp file
+ *            is removed and the target is left as it was.
+ */
+int atomic_file_commit(AtomicFile *af) {
+    int ok = fflush(af->f) == 0 && !ferror(af->f) && fsync(fileno(af->f)) == 0;
+    struct stat st;
+    if (ok && fstat(fileno(af->f), &st) == 0) {
+        af->size = st.st_size;
+        af->mtime_ns = (long long)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        if (st.st_size > 0) METRIC_WRITTEN(st.st_size);
+    } else {
+        ok = 0;
+    }
+    if (fclose(af->f) != 0) ok = 0;
+    af->f = NULL;
+    if (!ok || rename(af->tmp, af->path) != 0) {
+        remove(af->tmp);
+        return -1;
+    }
+    return sync_parent_dir(af->path);
+}
+
+/**
+ * ? Give up on a rewrite started with atomic_file_open().
+ */
+void atomic_file_abort(AtomicFile *af) {
+    if (af->f) fclose(af->f);
+    af->f = NULL;
+    remove(af->tmp);
+}
@@ -0,0 +1,239 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "batch.h"
+#include "fileio.h"
+#include "utils.h"
+#include "admin.h"
+#include "student.h"
+#include "client.h"
+#include "binstore.h"
+#include "metrics.h"
+
+static const char *const commands[] = {"vote", "publish", "tally", "batch", "convert"};
+
+//* Replies; stdout itself is pointed at stderr by batch_begin()
+static FILE *out;
+
+bool batch_is_command(const char *name) {
+    for (size_t i = 0; i < sizeof commands / sizeof *commands; i++)
+        if (strcmp(name, commands[i]) == 0) return true;
+    return false;
+}
+
+/**
+ * ? Split replies from the status lines printed by the shared code.
+ *
+ * Loaders, publish and the integrity pass report through printf(); in batch
+ * mode those lines move to stderr so a script can read stdout as pure
+ * replies.
+ */
+void batch_begin(void) {
+    fflush(stdout);
+    int fd = dup(STDOUT_FILENO);
+    out = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!out) {
+        out = stdout;
+        return;
+    }
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+}
+
+/**
+ * ? Reload the state if `username` is unknown (registered by another instance).
+ */
+static const User *find_user(ElectionState *st, const char *username) {
+    const User *u = user_store_find(&st->users, username);
+    if (u) return u;
+    state_refresh(st);
+    return user_store_find(&st->users, username);
+}
+
+/**
+ * ? Validate and record one ballot, through the vote daemon when one runs.
+ *
+ * Unlike the student menu, the rep must be a current candidate.
+ *
+ * @return Reply text (without newline).
+ */
+static const char *do_vote(ElectionState *st, const char *student, const char *rep) {
+    const User *u = find_user(st, student);
+    if (!u || u->role != ROLE_STUDENT) return "ERR not-a-student";
+    if (name_index_get(&st->tally.ids, rep) < 0) {
+        state_refresh(st);
+        if (name_index_get(&st->tally.ids, rep) < 0) return "ERR not-a-candidate";
+    }
+
+    int result;
+    if (client_active()) {
+        result = client_vote(student, rep);
+    } else {
+        Vote v;
+        strcpy(v.student_username, u->username);
+        strcpy(v.rep_username, rep);
+        result = state_add_vote(st, &v);
+    }
+    if (result == 1) return "ERR already-voted";
+    if (result == 2) return "ERR not-a-candidate";
+    return result == 0 ? "OK" : "ERR storage";
+}
+
+/**
+ * ? Publish the current results; same steps as the admin menu.
+ *
+ * @return The published epoch, or -1 on failure.
+ */
+static int do_publish(ElectionState *st) {
+    state_refresh(st);
+    if (!check_default_admin_at_top()) return -1;
+    int epoch = publish_results(st);
+    state_checkpoint(st);
+    if (epoch >= 0 && state_mark_published(st, epoch) != 0) return -1;
+    return epoch;
+}
+
+//* Live counts in manifesto order: "rep count" lines, or one JSON object
+static void print_tally(ElectionState *st, bool json) {
+    state_refresh(st);
+    if (!json) {
+        for (int i = 0; i < st->mfCount; i++)
+            fprintf(out, "%s %d\n", st->mfs[i].rep_username,
+                    tally_votes_for(&st->tally, st->mfs[i].rep_username));
+        return;
+    }
+    fprintf(out, "{\"votes\":%d,\"published_epoch\":%d,\"candidates\":[", st->log.count, st->publishedEpoch);
+    for (int i = 0; i < st->mfCount; i++) {
+        fprintf(out, "%s{\"rep\":", i ? "," : "");
+        json_print_string(out, st->mfs[i].rep_username);
+        fprintf(out, ",\"votes\":%d}", tally_votes_for(&st->tally, st->mfs[i].rep_username));
+    }
+    fprintf(out, "]}\n");
+}
+
+/**
+ * ? Serve the line protocol on stdin until EOF or QUIT.
+ *
+ * Replies are flushed after every line so a frontend can drive the
+ * protocol interactively over a pipe. A long session rewrites the
+ * metrics file like the menus do.
+ *
+ * @return 0, or 1 if any request failed.
+ */
+static int run_protocol(ElectionState *st) {
+    char line[256], cmd[16], a[USERNAME_LEN], b[PASS_LEN];
+    int failed = 0;
+    while (fgets(line, sizeof line, stdin)) {
+        int argc = sscanf(line, "%15s %31s %31s", cmd, a, b);
+        if (argc < 1 || cmd[0] == '#') continue;
+
+        if (strcmp(cmd, "QUIT") == 0) {
+            break;
+        } else if (strcmp(cmd, "PING") == 0) {
+            fprintf(out, "PONG\n");
+        } else if (strcmp(cmd, "VOTE") == 0 && argc == 3) {
+            const char *r = do_vote(st, a, b);
+            failed |= r[0] != 'O';
+            fprintf(out, "%s\n", r);
+        } else if (strcmp(cmd, "VOTED") == 0 && argc == 2) {
+            int voted = client_active() ? client_has_voted(a) : -1;
+            if (voted < 0) {
+                state_refresh(st);
+                voted = state_has_voted(st, a);
+            }
+            fprintf(out, voted ? "YES\n" : "NO\n");
+        } else if (strcmp(cmd, "LOGIN") == 0 && argc == 3) {
+            User u;
+            find_user(st, a);
+            if (authenticate(&st->users, a, b, &u)) fprintf(out, "OK %d\n", u.role);
+            else fprintf(out, "ERR credentials\n");
+        } else if (strcmp(cmd, "PUBLISH") == 0 && argc == 1) {
+            int epoch = do_publish(st);
+            failed |= epoch < 0;
+            if (epoch >= 0) fprintf(out, "OK %d\n", epoch);
+            else fprintf(out, "ERR storage\n");
+        } else if (strcmp(cmd, "TALLY") == 0 && argc == 1) {
+            print_tally(st, false);
+            fprintf(out, "END\n");
+        } else if (strcmp(cmd, "TALLY") == 0 && argc == 2 && strcmp(a, "JSON") == 0) {
+            print_tally(st, true);
+        } else {
+            failed = 1;
+            fprintf(out, "ERR syntax\n");
+        }
+        fflush(out);
+        metrics_maybe_flush();
+    }
+    return failed;
+}
+
+/**
+ * ? `election convert tobin|totext users|votes|manifestos`
+ */
+static int run_convert(int argc, char **argv) {
+    static const struct { const char *name; BinKind kind; } files[] = {
+        {"users", BIN_USERS}, {"votes", BIN_VOTES}, {"manifestos", BIN_MANIFESTOS}
+    };
+    if (argc != 3) return -2;
+    bool tobin = strcmp(argv[1], "tobin") == 0;
+    if (!tobin && strcmp(argv[1], "totext") != 0) return -2;
+    for (size_t i = 0; i < sizeof files / sizeof *files; i++) {
+        if (strcmp(argv[2], files[i].name) != 0) continue;
+        int lock = storage_lock();
+        int rc = tobin ? bin_convert_from_text(files[i].kind) : bin_convert_to_text(files[i].kind);
+        storage_unlock(lock);
+        return rc;
+    }
+    return -2;
+}
+
+/**
+ * ? Run one batch command against the loaded state.
+ *
+ * @param st    Election state loaded by main().
+ * @param argc  Arguments from the command name on.
+ * @param argv  argv[0] is one of the batch commands.
+ * @return      Process exit code: 0 success, 1 refused or failed, 2 usage error.
+ *
+ * * Usage:
+ *   - `election vote alice bob`, `election tally --json`,
+ *     `kiosk | election batch`
+ */
+int batch_run(ElectionState *st, int argc, char **argv) {
+    if (!out) out = stdout;
+    if (client_detect(Server_Socket_Path))
+        fprintf(stderr, "[INFO] Forwarding ballots to the vote daemon.\n");
+
+    int rc = -2;
+    if (strcmp(argv[0], "vote") == 0 && argc == 3) {
+        const char *r = do_vote(st, argv[1], argv[2]);
+        fprintf(out, "%s\n", r);
+        rc = r[0] == 'O' ? 0 : -1;
+    } else if (strcmp(argv[0], "publish") == 0 && argc == 1) {
+        int epoch = do_publish(st);
+        if (epoch >= 0) fprintf(out, "OK %d\n", epoch);
+        else fprintf(out, "ERR storage\n");
+        rc = epoch >= 0 ? 0 : -1;
+    } else if (strcmp(argv[0], "tally") == 0 && argc <= 2) {
+        bool json = argc == 2 && strcmp(argv[1], "--json") == 0;
+        if (argc == 1 || json) {
+            print_tally(st, json);
+            rc = 0;
+        }
+    } else if (strcmp(argv[0], "batch") == 0 && argc == 1) {
+        rc = run_protocol(st) == 0 ? 0 : -1;
+    } else if (strcmp(argv[0], "convert") == 0) {
+        rc = run_convert(argc, argv);
+        if (rc == 0) fprintf(out, "OK\n");
+        else if (rc == -1) fprintf(out, "ERR storage\n");
+    }
+
+    fflush(out);
+    if (rc == -2) {
+        fprintf(stderr, "usage: election vote <student> <rep> | publish | tally [--json] | batch\n"
+                        "       election convert tobin|totext users|votes|manifestos\n");
+        return 2;
+    }
+    return rc == 0 ? 0 : 1;
+}
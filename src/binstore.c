@@ -0,0 +1,210 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "binstore.h"
+#include "fileio.h"
+#include "atomicfile.h"
+#include "metrics.h"
+
+/**
+ * ? Size of one record of the given kind.
+ *
+ * @return sizeof the matching struct, or 0 for an unknown kind.
+ */
+static size_t record_size(BinKind kind) {
+    switch (kind) {
+        case BIN_USERS:      return sizeof(User);
+        case BIN_VOTES:      return sizeof(Vote);
+        case BIN_MANIFESTOS: return sizeof(Manifesto);
+    }
+    return 0;
+}
+
+/**
+ * ? FNV-1a checksum over a block of record bytes.
+ */
+static uint32_t checksum(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * ? Read size and modification time of the text file a snapshot mirrors.
+ *
+ * Take the stamp *before* parsing the text: a change made while it is read
+ * then leaves the snapshot looking stale (rebuilt next time), never fresh.
+ *
+ * @return 0 on success; -1 if the file cannot be stat'ed.
+ */
+int bin_stamp(const char *src_path, BinStamp *out) {
+    struct stat st;
+    if (stat(src_path, &st) != 0) return -1;
+    out->size = st.st_size;
+    out->mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    return 0;
+}
+
+/**
+ * ? Write a binary snapshot: header followed by the raw records.
+ *
+ * @param path      Destination file.
+ * @param kind      Record type stored in the file.
+ * @param records   Array of `count` User/Vote/Manifesto records.
+ * @param count     Number of records.
+ * @param src       Stamp of the text file the records were read from (or
+ *                  written to), stored so bin_load() can detect a stale
+ *                  snapshot. May be NULL.
+ * @return          0 on success; -1 on I/O failure.
+ */
+int bin_save(const char *path, BinKind kind, const void *records, int count, const BinStamp *src) {
+    BinHeader h = {0};
+    size_t rs = record_size(kind);
+    memcpy(h.magic, BIN_MAGIC, 4);
+    h.version = BIN_FORMAT_VERSION;
+    h.kind = kind;
+    h.record_size = rs;
+    h.record_count = count;
+    h.checksum = checksum(records, rs * count);
+    if (src) {
+        h.src_size = src->size;
+        h.src_mtime_ns = src->mtime_ns;
+    }
+
+    AtomicFile af;
+    if (atomic_file_open(&af, path, "wb") != 0) return -1;
+    int ok = fwrite(&h, sizeof h, 1, af.f) == 1 &&
+             (count == 0 || fwrite(records, rs, count, af.f) == (size_t)count);
+    if (!ok) { atomic_file_abort(&af); return -1; }
+    return atomic_file_commit(&af);
+}
+
+/**
+ * ? Load a binary snapshot with a single read of the record block.
+ *
+ * Rejects the file (returns -1) if the header does not match this build
+ * (magic, version, kind, record size), if the checksum fails, or if
+ * `src_path` is given and its size/mtime differ from the recorded ones.
+ *
+ * @param path      Snapshot file.
+ * @param kind      Expected record type.
+ * @param[out] out  Allocated record array (NULL when empty).
+ * @param src_path  Text file to check freshness against, or NULL.
+ * @return          Number of records, or -1 if the snapshot is unusable.
+ *
+ * @note Caller must free `*out`.
+ */
+int bin_load(const char *path, BinKind kind, void **out, const char *src_path) {
+    *out = NULL;
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+
+    BinHeader h;
+    size_t rs = record_size(kind);
+    if (fread(&h, sizeof h, 1, f) != 1 ||
+        memcmp(h.magic, BIN_MAGIC, 4) != 0 ||
+        h.version != BIN_FORMAT_VERSION ||
+        h.kind != (uint32_t)kind ||
+        h.record_size != rs) {
+        fclose(f);
+        return -1;
+    }
+    if (src_path) {
+        BinStamp now;
+        if (bin_stamp(src_path, &now) != 0 ||
+            now.size != h.src_size || now.mtime_ns != h.src_mtime_ns) {
+            fclose(f);
+            return -1;
+        }
+    }
+
+    void *records = NULL;
+    if (h.record_count > 0) {
+        records = malloc(rs * h.record_count);
+        if (!records ||
+            fread(records, rs, h.record_count, f) != h.record_count ||
+            checksum(records, rs * h.record_count) != h.checksum) {
+            free(records);
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    METRIC_READ(sizeof h + rs * h.record_count);
+    *out = records;
+    return (int)h.record_count;
+}
+
+/**
+ * ? Build the binary snapshot of a text file.
+ *
+ * Parses users.txt, votes.txt or manifestos.txt and writes the matching
+ * .bin file next to it.
+ *
+ * @param kind  Which file to convert.
+ * @return      0 on success; -1 on failure.
+ */
+int bin_convert_from_text(BinKind kind) {
+    void *records = NULL;
+    int n, result;
+    BinStamp src;
+    switch (kind) {
+        case BIN_USERS:
+            if (bin_stamp(Users_Path, &src) != 0) return -1;
+            n = load_users_text((User **)&records);
+            result = bin_save(Users_Bin_Path, kind, records, n, &src);
+            break;
+        case BIN_VOTES:
+            if (bin_stamp(Votes_Path, &src) != 0) return -1;
+            n = load_votes_text((Vote **)&records);
+            result = bin_save(Votes_Bin_Path, kind, records, n, &src);
+            break;
+        case BIN_MANIFESTOS:
+            if (bin_stamp(Manifesto_Path, &src) != 0) return -1;
+            n = load_manifestos_text((Manifesto **)&records);
+            result = bin_save(Manifesto_Bin_Path, kind, records, n, &src);
+            break;
+        default:
+            return -1;
+    }
+    free(records);
+    return result;
+}
+
+/**
+ * ? Regenerate a text file from its binary snapshot.
+ *
+ * The snapshot is accepted regardless of the text file's current state.
+ *
+ * @param kind  Which file to convert.
+ * @return      0 on success; -1 if the snapshot is missing/corrupt or the
+ *              text file cannot be written.
+ */
+int bin_convert_to_text(BinKind kind) {
+    void *records = NULL;
+    int n, result;
+    switch (kind) {
+        case BIN_USERS:
+            if ((n = bin_load(Users_Bin_Path, kind, &records, NULL)) < 0) return -1;
+            result = save_users(records, n);
+            break;
+        case BIN_VOTES:
+            if ((n = bin_load(Votes_Bin_Path, kind, &records, NULL)) < 0) return -1;
+            result = save_votes(records, n);
+            break;
+        case BIN_MANIFESTOS:
+            if ((n = bin_load(Manifesto_Bin_Path, kind, &records, NULL)) < 0) return -1;
+            result = save_manifestos(records, n);
+            break;
+        default:
+            return -1;
+    }
+    free(records);
+    return result;
+}
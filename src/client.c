@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "client.h"
+
+static char daemon_path[108];
+static bool active = false;
+
+/**
+ * ? Send one request line to the daemon and read its whole reply.
+ *
+ * @return 0 on success; -1 if the daemon cannot be reached.
+ */
+static int request(const char *line, char *resp, size_t len) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, daemon_path, sizeof addr.sun_path - 1);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof addr) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    char buf[160];
+    int n = snprintf(buf, sizeof buf, "%s\n", line);
+    if (write(fd, buf, n) != n) {
+        close(fd);
+        return -1;
+    }
+
+    size_t got = 0;
+    ssize_t r;
+    while (got + 1 < len && (r = read(fd, resp + got, len - 1 - got)) > 0)
+        got += r;
+    resp[got] = '\0';
+    close(fd);
+    return got > 0 ? 0 : -1;
+}
+
+/**
+ * ? Look for a running vote daemon.
+ *
+ * @param sock_path  Daemon socket in the data directory.
+ * @return           true if it answered a PING; later client_* calls go to it.
+ *
+ * * Usage:
+ *   - Called once by main() at startup.
+ */
+bool client_detect(const char *sock_path) {
+    char resp[16];
+    strncpy(daemon_path, sock_path, sizeof daemon_path - 1);
+    active = request("PING", resp, sizeof resp) == 0 && strncmp(resp, "PONG", 4) == 0;
+    return active;
+}
+
+bool client_active(void) {
+    return active;
+}
+
+/**
+ * ? Authenticate through the daemon.
+ *
+ * @return 1 on success (outUser filled), 0 on wrong credentials,
+ *         -1 if the daemon cannot be reached.
+ */
+int client_login(const char *username, const char *password, User *outUser) {
+    char line[96], resp[32];
+    snprintf(line, sizeof line, "LOGIN %s %s", username, password);
+    if (request(line, resp, sizeof resp) != 0) return -1;
+
+    int role;
+    if (sscanf(resp, "OK %d", &role) != 1) return 0;
+    memset(outUser, 0, sizeof *outUser);
+    strncpy(outUser->username, username, USERNAME_LEN - 1);
+    strncpy(outUser->password, password, PASS_LEN - 1);
+    outUser->role = (Role)role;
+    return 1;
+}
+
+/**
+ * ? Ask the daemon whether a student has voted (committed or pending).
+ *
+ * @return 1 if voted, 0 if not, -1 if the daemon cannot be reached.
+ */
+int client_has_voted(const char *student) {
+    char line[64], resp[16];
+    snprintf(line, sizeof line, "VOTED %s", student);
+    if (request(line, resp, sizeof resp) != 0) return -1;
+    return strncmp(resp, "YES", 3) == 0;
+}
+
+/**
+ * ? Cast a ballot through the daemon; returns once it is durable.
+ *
+ * @return 0 on success, 1 if the student already voted, 2 if the rep is
+ *         not a candidate, -1 on any other error (daemon unreachable,
+ *         storage failure, invalid ballot).
+ */
+int client_vote(const char *student, const char *rep) {
+    char line[96], resp[32];
+    snprintf(line, sizeof line, "VOTE %s %s", student, rep);
+    if (request(line, resp, sizeof resp) != 0) return -1;
+    if (strncmp(resp, "OK", 2) == 0) return 0;
+    if (strncmp(resp, "ERR already-voted", 17) == 0) return 1;
+    if (strncmp(resp, "ERR not-a-candidate", 19) == 0) return 2;
+    return -1;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "export.h"
+#include "fileio.h"
+#include "utils.h"
+#include "tally.h"
+#include "linereader.h"
+#include "atomicfile.h"
+
+//* scan_users() visitor: count the students (the electorate)
+static int count_student(const User *u, void *ctx) {
+    if (u->role == ROLE_STUDENT) (*(int *)ctx)++;
+    return 0;
+}
+
+/**
+ * ? Register every candidate of manifestos.txt (the name before '|').
+ *
+ * @return 0, or -1 if the tally cannot grow.
+ */
+static int add_candidates(Tally *t) {
+    LineReader r;
+    if (line_reader_open(&r, Manifesto_Path) != 0) return 0;
+    const char *line;
+    size_t len;
+    int rc = 0;
+    while (rc == 0 && (line = line_reader_next(&r, &len))) {
+        const char *bar = memchr(line, '|', len);
+        char name[USERNAME_LEN];
+        if (!bar || bar == line || field_copy((Field){line, bar - line}, name, sizeof name) != 0) continue;
+        if (tally_add_candidate(t, name) < 0) rc = -1;
+    }
+    line_reader_close(&r);
+    return rc;
+}
+
+//* scan_votes() visitor: one vote for the rep (ignored if not a candidate)
+static int count_vote(const Vote *v, void *ctx) {
+    Tally *t = ctx;
+    tally_count_rep(t, v->rep_username, strlen(v->rep_username));
+    return 0;
+}
+
+//* part / whole as a percentage, 0 when there is no whole
+static double pct(int part, int whole) {
+    return whole > 0 ? 100.0 * part / whole : 0.0;
+}
+
+/**
+ * ? Write the live results with per-candidate turnout.
+ *
+ * Reads votes.txt and the vote journal once through scan_votes() (same
+ * parser as load_votes(), LINE_READER_BLOCK chunks), under the storage
+ * lock so a concurrent compaction cannot move votes between the two files
+ * mid-scan. No Vote records are kept: only one
+ * counter per candidate, so memory does not grow with the election.
+ * Ballots are counted as stored (the writers already refuse double votes);
+ * ballots for reps without a manifesto are reported as "other".
+ *
+ * Per candidate: live votes, share of all ballots, turnout (votes as a
+ * share of the electorate) and the last published count.
+ *
+ * @param out  Destination stream.
+ * @param fmt  EXPORT_CSV (one row per candidate plus a TOTAL row) or
+ *             EXPORT_JSON (one object).
+ * @return     0 on success; -1 on lock, memory or write errors.
+ */
+int export_results(FILE *out, ExportFormat fmt) {
+    Tally t;
+    if (tally_init(&t, 16) != 0) return -1;
+    int lock = storage_lock();
+    if (lock < 0 || add_candidates(&t) != 0) {
+        storage_unlock(lock);
+        tally_free(&t);
+        return -1;
+    }
+    int votes = scan_votes(count_vote, &t);
+    int students = 0;
+    scan_users(count_student, &students);
+    int publishedEpoch = load_published_epoch();
+    Manifesto *resMfs = NULL;
+    int *resCounts = NULL;
+    int resCount = load_results(&resMfs, &resCounts, NULL);
+    storage_unlock(lock);
+
+    int counted = 0;
+    for (int i = 0; i < t.count; i++) counted += t.counts[i];
+    int *published = calloc(t.count ? t.count : 1, sizeof *published);
+    for (int k = 0; published && k < resCount; k++) {
+        int id = name_index_get(&t.ids, resMfs[k].rep_username);
+        if (id >= 0) published[id] = resCounts[k];
+    }
+    free(resMfs);
+    free(resCounts);
+    if (!published) {
+        tally_free(&t);
+        return -1;
+    }
+
+    if (fmt == EXPORT_CSV) {
+        fprintf(out, "candidate,votes,vote_share_pct,turnout_pct,published_votes\n");
+    } else {
+        fprintf(out, "{\"students\":%d,\"votes\":%d,\"other\":%d,\"turnout_pct\":%.2f,"
+                     "\"published_epoch\":%d,\"candidates\":[",
+                students, votes, votes - counted, pct(votes, students), publishedEpoch);
+    }
+    for (int i = 0; i < t.count; i++) {
+        if (fmt == EXPORT_CSV) {
+            fprintf(out, "%s,%d,%.2f,%.2f,%d\n", t.names[i], t.counts[i],
+                    pct(t.counts[i], votes), pct(t.counts[i], students), published[i]);
+        } else {
+            fprintf(out, "%s{\"rep\":", i ? "," : "");
+            json_print_string(out, t.names[i]);
+            fprintf(out, ",\"votes\":%d,\"vote_share_pct\":%.2f,\"turnout_pct\":%.2f,\"published_votes\":%d}",
+                    t.counts[i], pct(t.counts[i], votes), pct(t.counts[i], students), published[i]);
+        }
+    }
+    if (fmt == EXPORT_CSV) {
+        if (votes > counted)
+            fprintf(out, "other,%d,%.2f,%.2f,\n", votes - counted,
+                    pct(votes - counted, votes), pct(votes - counted, students));
+        fprintf(out, "TOTAL,%d,100.00,%.2f,\n", votes, pct(votes, students));
+    } else {
+        fprintf(out, "]}\n");
+    }
+
+    free(published);
+    tally_free(&t);
+    return ferror(out) ? -1 : 0;
+}
+
+/**
+ * ? `election export csv|json [file]`
+ *
+ * Writes to stdout, or atomically replaces `file`.
+ *
+ * @param argc  Arguments from "export" on.
+ * @param argv  argv[0] is "export".
+ * @return      Process exit code: 0 success, 1 failure, 2 usage error.
+ */
+int export_command(int argc, char **argv) {
+    if (argc < 2 || argc > 3 || (strcmp(argv[1], "csv") != 0 && strcmp(argv[1], "json") != 0)) {
+        fprintf(stderr, "usage: election export csv|json [file]\n");
+        return 2;
+    }
+    ExportFormat fmt = strcmp(argv[1], "json") == 0 ? EXPORT_JSON : EXPORT_CSV;
+    if (argc == 2) {
+        int rc = export_results(stdout, fmt);
+        return rc == 0 && fflush(stdout) == 0 ? 0 : 1;
+    }
+
+    AtomicFile af;
+    if (atomic_file_open(&af, argv[2], "w") != 0) {
+        fprintf(stderr, "[ERROR] Cannot write %s\n", argv[2]);
+        return 1;
+    }
+    if (export_results(af.f, fmt) != 0) {
+        atomic_file_abort(&af);
+        fprintf(stderr, "[ERROR] Export failed.\n");
+        return 1;
+    }
+    if (atomic_file_commit(&af) != 0) {
+        fprintf(stderr, "[ERROR] Cannot write %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(stderr, "[SUCCESS] Results exported to %s.\n", argv[2]);
+    return 0;
+}
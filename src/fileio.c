@@ -1,8 +1,18 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include "fileio.h"
 #include "models.h"
+#include "binstore.h"
+#include "nameindex.h"
+#include "atomicfile.h"
+#include "linereader.h"
+#include "metrics.h"
 
 
 /**
@@ -29,11 +39,127 @@ void ensure_file_exists(const char *fname) {
     fclose(f);
 }
 
+/**
+ * ? Take the exclusive data-directory lock.
+ *
+ * Every instance that modifies the vote log (terminals, the vote daemon,
+ * batch tools) holds this lock across its check-then-write sequence, so
+ * concurrent instances can never lose or duplicate ballots.
+ *
+ * @return Lock handle for storage_unlock(); -1 if the lock file cannot be
+ *         opened or locked.
+ *
+ * @note POSIX record locks are per process: do not nest calls.
+ */
+int storage_lock(void) {
+    int fd = open(Lock_Path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return -1;
+    struct flock fl = {0};
+    fl.l_type = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    if (fcntl(fd, F_SETLKW, &fl) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * ? Release the lock taken by storage_lock().
+ */
+void storage_unlock(int lock) {
+    if (lock >= 0) close(lock);
+}
+
+/**
+ * ? Report a malformed line that a loader skipped.
+ */
+static void skip_bad_line(const char *path, int lineNo, const char *why) {
+    fprintf(stderr, "[WARNING] %s line %d: %s; line skipped.\n", path, lineNo, why);
+}
+
+/**
+ * ? Visit every valid user of users.txt, in order, a block at a time.
+ *
+ * The only users.txt parser (load_users_text() collects through it). Each
+ * line is "username password role", split by hand (no fscanf, no locale);
+ * malformed lines are reported with their line number and skipped.
+ *
+ * @param fn   Callback; return non-zero to stop.
+ * @param ctx  Passed through to `fn`.
+ * @return     Number of users visited; -1 if users.txt cannot be opened.
+ */
+int scan_users(UserVisitor fn, void *ctx) {
+    LineReader r;
+    if (line_reader_open(&r, Users_Path) != 0) return -1;
+    int visited = 0, stop = 0;
+    const char *line;
+    size_t len;
+    while (!stop && (line = line_reader_next(&r, &len))) {
+        Field f[3];
+        int n = line_fields(line, len, f, 3);
+        if (n == 0) continue;
+        User u;
+        int role;
+        if (n != 3) { skip_bad_line(Users_Path, r.lineNo, "expected \"username password role\""); continue; }
+        if (field_copy(f[0], u.username, USERNAME_LEN) != 0 ||
+            field_copy(f[1], u.password, PASS_LEN) != 0) {
+            skip_bad_line(Users_Path, r.lineNo, "username or password too long");
+            continue;
+        }
+        if (field_int(f[2], &role) != 0 || role < ROLE_ADMIN || role > ROLE_STUDENT) {
+            skip_bad_line(Users_Path, r.lineNo, "role must be 0, 1 or 2");
+            continue;
+        }
+        u.role = role;
+        visited++;
+        stop = fn(&u, ctx);
+    }
+    line_reader_close(&r);
+    return visited;
+}
+
+//* Growing User array filled by scan_users()
+typedef struct {
+    User *arr;
+    int cap, cnt;
+} UserArray;
+
+static int append_user_to_array(const User *u, void *ctx) {
+    UserArray *a = ctx;
+    if (a->cnt == a->cap) {
+        int cap = a->cap ? a->cap * 2 : 64;
+        User *grown = realloc(a->arr, cap * sizeof *grown);
+        if (!grown) return 1;
+        a->arr = grown;
+        a->cap = cap;
+    }
+    a->arr[a->cnt++] = *u;
+    return 0;
+}
+
+/**
+ * ? Parse users.txt into memory, bypassing the binary cache.
+ *
+ * Collects every user scan_users() accepts into one array.
+ *
+ * @param[out] out  Destination pointer for the allocated User array.
+ * @return           Number of users loaded (may be zero).
+ *
+ * @note Caller should free `*out` when done.
+ */
+int load_users_text(User **out) {
+    UserArray a = {0};
+    scan_users(append_user_to_array, &a);
+    *out = a.arr; return a.cnt;
+}
+
 /**
  * ? Load all users from disk into memory.
  *
- * Reads lines from `Users_Path`, parsing username, password, and role.
- * Dynamically reallocates as needed.
+ * Uses the binary snapshot `Users_Bin_Path` (one read, no parsing) when it
+ * is up to date with users.txt; otherwise parses the text file and
+ * refreshes the snapshot for the next load.
  *
  * @param[out] out  Destination pointer for the allocated User array.
  * @return           Number of users loaded (may be zero).
@@ -41,17 +167,20 @@ void ensure_file_exists(const char *fname) {
  * @note Caller should free `*out` when done.
  */
 int load_users(User **out) {
-    FILE *f = fopen(Users_Path, "r");
-    if (!f) { *out = NULL; return 0; }
-    User *arr = NULL; int cap = 0, cnt = 0;
-    while (!feof(f)) {
-        User u;
-        if (fscanf(f, "%31s %31s %d\n", u.username, u.password, (int*)&u.role) != 3)
-            break;
-        if (cnt == cap) arr = realloc(arr, (cap = cap ? cap*2 : 4) * sizeof *arr);
-        arr[cnt++] = u;
+    METRIC_START(t);
+#if USE_BINARY_CACHE
+    int n = bin_load(Users_Bin_Path, BIN_USERS, (void **)out, Users_Path);
+    if (n < 0) {
+        BinStamp src;
+        bool stamped = bin_stamp(Users_Path, &src) == 0;  // before parsing, see bin_stamp()
+        n = load_users_text(out);
+        if (stamped) bin_save(Users_Bin_Path, BIN_USERS, *out, n, &src);
     }
-    fclose(f); *out = arr; return cnt;
+#else
+    int n = load_users_text(out);
+#endif
+    METRIC_STOP(MET_LOAD_USERS, t);
+    return n;
 }
 
 /**
@@ -83,23 +212,44 @@ int load_reps(User **outReps) {
 /**
  * ? Save an array of users to disk.
  *
- * Opens `Users_Path` for writing, then writes each user's
- * username, password, and role.
+ * Writes each user's username, password, and role to a temp file that
+ * atomically replaces `Users_Path` (a crash leaves the old or the new
+ * file, never a truncated one). The binary snapshot is refreshed too.
  *
  * @param arr    Array of users to save.
  * @param count  Number of entries.
- * @return       0 on success; -1 on file open failure.
+ * @return       0 on success; -1 on write failure (`Users_Path` untouched).
  */
 int save_users(const User *arr, int count) {
-    FILE *f = fopen(Users_Path, "w");
-    if (!f) return -1;
+    METRIC_START(t);
+    AtomicFile af;
+    if (atomic_file_open(&af, Users_Path, "w") != 0) return -1;
     for (int i = 0; i < count; i++)
-        fprintf(f, "%s %s %d\n", arr[i].username, arr[i].password, arr[i].role);
+        fprintf(af.f, "%s %s %d\n", arr[i].username, arr[i].password, arr[i].role);
+    if (atomic_file_commit(&af) != 0) return -1;
+#if USE_BINARY_CACHE
+    bin_save(Users_Bin_Path, BIN_USERS, arr, count, &(BinStamp){af.size, af.mtime_ns});
+#endif
+    METRIC_STOP(MET_SAVE_USERS, t);
+    return 0;
+}
+
+/**
+ * ? Append a single user to the end of the users file.
+ *
+ * @param u  User to append.
+ * @return   0 on success; -1 on file open failure.
+ */
+int append_user(const User *u) {
+    FILE *f = fopen(Users_Path, "a");
+    if (!f) return -1;
+    int n = fprintf(f, "%s %s %d\n", u->username, u->password, u->role);
+    if (n > 0) METRIC_WRITTEN(n);
     fclose(f); return 0;
 }
 
 /**
- * ? Load all candidate manifestos.
+ * ? Parse manifestos.txt, bypassing the binary cache.
  *
  * Reads each line formatted as "username|manifesto" from `Manifesto_Path`,
  * splitting on '|', stripping trailing newline from manifesto.
@@ -109,16 +259,18 @@ int save_users(const User *arr, int count) {
  *
  * @note Caller must free `*out`.
  */
-int load_manifestos(Manifesto **out) {
+int load_manifestos_text(Manifesto **out) {
     FILE *f = fopen(Manifesto_Path, "r");
     if (!f) { *out = NULL; return 0; }
     Manifesto *arr = NULL; int cap = 0, cnt = 0;
     char buf[600];
     while (fgets(buf, sizeof buf, f)) {
+        METRIC_READ(strlen(buf));
         char *p = strchr(buf, '|');
         if (!p) continue;
         *p = 0;
         if (cnt == cap) arr = realloc(arr, (cap = cap ? cap*2 : 4) * sizeof *arr);
+        memset(&arr[cnt], 0, sizeof arr[cnt]);
         strcpy(arr[cnt].rep_username, buf);
         strcpy(arr[cnt].manifesto, p+1);
         arr[cnt].manifesto[strcspn(arr[cnt].manifesto, "\n")] = 0;
@@ -127,26 +279,150 @@ int load_manifestos(Manifesto **out) {
     fclose(f); *out = arr; return cnt;
 }
 
+/**
+ * ? Load all candidate manifestos.
+ *
+ * Same binary-cache strategy as load_users(), with `Manifesto_Bin_Path`.
+ *
+ * @param[out] out  Destination pointer for allocated Manifesto array.
+ * @return           Number of manifestos loaded.
+ *
+ * @note Caller must free `*out`.
+ */
+int load_manifestos(Manifesto **out) {
+    METRIC_START(t);
+#if USE_BINARY_CACHE
+    int n = bin_load(Manifesto_Bin_Path, BIN_MANIFESTOS, (void **)out, Manifesto_Path);
+    if (n < 0) {
+        BinStamp src;
+        bool stamped = bin_stamp(Manifesto_Path, &src) == 0;  // before parsing, see bin_stamp()
+        n = load_manifestos_text(out);
+        if (stamped) bin_save(Manifesto_Bin_Path, BIN_MANIFESTOS, *out, n, &src);
+    }
+#else
+    int n = load_manifestos_text(out);
+#endif
+    METRIC_STOP(MET_LOAD_MANIFESTOS, t);
+    return n;
+}
+
 /**
  * ? Save an array of manifestos to disk.
  *
- *  Writes each record as "rep_username|manifesto\n" to `Manifesto_Path`.
+ *  Writes each record as "rep_username|manifesto\n"; the file atomically
+ *  replaces `Manifesto_Path`.
  *
  * @param arr    Manifesto array.
  * @param count  Number of entries.
- * @return       0 on success; -1 on failure to open file.
+ * @return       0 on success; -1 on write failure (`Manifesto_Path` untouched).
  */
 int save_manifestos(const Manifesto *arr, int count) {
-    FILE *f = fopen(Manifesto_Path, "w");
-    if (!f) return -1;
+    METRIC_START(t);
+    AtomicFile af;
+    if (atomic_file_open(&af, Manifesto_Path, "w") != 0) return -1;
     for (int i = 0; i < count; i++)
-        fprintf(f, "%s|%s\n", arr[i].rep_username, arr[i].manifesto);
-    fclose(f); return 0;
+        fprintf(af.f, "%s|%s\n", arr[i].rep_username, arr[i].manifesto);
+    if (atomic_file_commit(&af) != 0) return -1;
+#if USE_BINARY_CACHE
+    bin_save(Manifesto_Bin_Path, BIN_MANIFESTOS, arr, count, &(BinStamp){af.size, af.mtime_ns});
+#endif
+    METRIC_STOP(MET_SAVE_MANIFESTOS, t);
+    return 0;
+}
+//* Fill `v` from the fields of a vote line; NULL, or why the line is malformed
+static const char *vote_from_fields(const Field *f, int n, Vote *v) {
+    if (n != 2) return "expected \"student rep\"";
+    if (field_copy(f[0], v->student_username, USERNAME_LEN) != 0 ||
+        field_copy(f[1], v->rep_username, USERNAME_LEN) != 0)
+        return "username too long";
+    return NULL;
+}
+
+/**
+ * ? Visit the ballots of one vote file, in order, a block at a time.
+ *
+ * The single parser behind load_votes(), load_votes_text() and
+ * scan_votes(). A leading "#base N" line (vote journal) means the entries
+ * follow a snapshot of N votes; when `*seen` already exceeds N, the first
+ * `*seen - N` entries were folded into the snapshot and are skipped.
+ * Malformed lines are reported with their line number and skipped.
+ *
+ * @param path          Votes snapshot or journal (a missing file visits nothing).
+ * @param[in,out] seen  Ballots visited so far; incremented per visited ballot.
+ * @param fn            Callback; return non-zero to stop.
+ * @param ctx           Passed through to `fn`.
+ * @return              Non-zero if `fn` stopped the scan.
+ */
+static int visit_vote_file(const char *path, int *seen, VoteVisitor fn, void *ctx) {
+    LineReader r;
+    if (line_reader_open(&r, path) != 0) return 0;
+    int skip = 0, stop = 0;
+    const char *line;
+    size_t len;
+    while (!stop && (line = line_reader_next(&r, &len))) {
+        Field f[2];
+        int n = line_fields(line, len, f, 2);
+        if (n == 0) continue;
+        if (r.lineNo == 1 && f[0].len == 5 && memcmp(f[0].p, "#base", 5) == 0) {
+            int base;
+            if (n == 2 && field_int(f[1], &base) == 0 && *seen > base) skip = *seen - base;
+            continue;
+        }
+        Vote v;
+        const char *why = vote_from_fields(f, n, &v);
+        if (why) { skip_bad_line(path, r.lineNo, why); continue; }
+        if (skip > 0) { skip--; continue; }
+        (*seen)++;
+        stop = fn(&v, ctx);
+    }
+    line_reader_close(&r);
+    return stop;
+}
+
+//* Growing Vote array filled by visit_vote_file()
+typedef struct {
+    Vote *arr;
+    int cap, cnt;
+} VoteArray;
+
+static int append_to_array(const Vote *v, void *ctx) {
+    VoteArray *a = ctx;
+    if (a->cnt == a->cap) {
+        int cap = a->cap ? a->cap * 2 : 64;
+        Vote *grown = realloc(a->arr, cap * sizeof *grown);
+        if (!grown) return 1;
+        a->arr = grown;
+        a->cap = cap;
+    }
+    a->arr[a->cnt++] = *v;
+    return 0;
+}
+
+/**
+ * ? Parse the votes.txt snapshot, bypassing the binary cache and the journal.
+ *
+ * @param[out] out  Destination pointer for allocated Vote array.
+ * @return           Number of votes loaded.
+ *
+ * @note Caller must free `*out`.
+ */
+int load_votes_text(Vote **out) {
+    VoteArray a = {0};
+    int seen = 0;
+    visit_vote_file(Votes_Path, &seen, append_to_array, &a);
+    *out = a.arr; return a.cnt;
 }
+
 /**
  * ? Load all votes from disk.
  *
- * Reads lines "student_username rep_username" into a dynamically allocated Vote array.
+ * Reads the snapshot `Votes_Path` (through its binary cache when fresh),
+ * then replays the append-only journal `Votes_Journal_Path` on top of it.
+ *
+ * The journal may start with a "#base N" line written by compact_votes():
+ * it means the journal entries follow a snapshot of N votes. If the snapshot
+ * already holds more than N votes (crash after the snapshot was rewritten but
+ * before the journal was reset), the already-folded entries are skipped.
  *
  * @param[out] out  Destination pointer for allocated Vote array.
  * @return           Number of votes loaded.
@@ -154,81 +430,319 @@ int save_manifestos(const Manifesto *arr, int count) {
  * @note Caller must free `*out`.
  */
 int load_votes(Vote **out) {
-    FILE *f = fopen(Votes_Path, "r");
-    if (!f) { *out = NULL; return 0; }
-    Vote *arr = NULL; int cap = 0, cnt = 0;
-    while (!feof(f)) {
-        Vote v;
-        if (fscanf(f, "%31s %31s\n", v.student_username, v.rep_username) != 2)
-            break;
-        if (cnt == cap) arr = realloc(arr, (cap = cap ? cap*2 : 4) * sizeof *arr);
-        arr[cnt++] = v;
+    METRIC_START(t);
+    VoteArray a = {0};
+#if USE_BINARY_CACHE
+    a.cnt = bin_load(Votes_Bin_Path, BIN_VOTES, (void **)&a.arr, Votes_Path);
+    if (a.cnt < 0) {
+        BinStamp src;
+        bool stamped = bin_stamp(Votes_Path, &src) == 0;  // before parsing, see bin_stamp()
+        a.cnt = load_votes_text(&a.arr);
+        if (stamped) bin_save(Votes_Bin_Path, BIN_VOTES, a.arr, a.cnt, &src);
     }
-    fclose(f); *out = arr; return cnt;
+#else
+    a.cnt = load_votes_text(&a.arr);
+#endif
+    a.cap = a.cnt;
+
+    int seen = a.cnt;
+    visit_vote_file(Votes_Journal_Path, &seen, append_to_array, &a);
+    METRIC_STOP(MET_LOAD_VOTES, t);
+    *out = a.arr; return a.cnt;
 }
 
 /**
  * ? Save a list of votes to disk.
  *
- * Serializes each Vote as "student_username rep_username\n" into `Votes_Path`.
+ * Serializes each Vote as "student_username rep_username\n"; the file
+ * atomically replaces `Votes_Path`.
  *
  * @param arr    Array of votes.
  * @param count  Number of votes.
- * @return       0 on success; -1 if file open fails.
+ * @return       0 on success; -1 on write failure (`Votes_Path` untouched).
  */
 int save_votes(const Vote *arr, int count) {
-    FILE *f = fopen(Votes_Path, "w");
-    if (!f) return -1;
+    METRIC_START(t);
+    AtomicFile af;
+    if (atomic_file_open(&af, Votes_Path, "w") != 0) return -1;
     for (int i = 0; i < count; i++)
-        fprintf(f, "%s %s\n", arr[i].student_username, arr[i].rep_username);
-    fclose(f); return 0;
+        fprintf(af.f, "%s %s\n", arr[i].student_username, arr[i].rep_username);
+    if (atomic_file_commit(&af) != 0) return -1;
+#if USE_BINARY_CACHE
+    bin_save(Votes_Bin_Path, BIN_VOTES, arr, count, &(BinStamp){af.size, af.mtime_ns});
+#endif
+    METRIC_STOP(MET_SAVE_VOTES, t);
+    return 0;
+}
+
+//* Journal handle kept open between ballots so each vote is a single append
+static FILE *journal = NULL;
+static int journal_unsynced = 0;
+
+/**
+ * ? Open the vote journal for appending, or reuse the open handle.
+ *
+ * compact_votes() replaces the journal by rename, possibly from another
+ * process; a handle kept from before would append to the orphaned file.
+ * One fstat() spots that (no links left) and the journal is reopened.
+ *
+ * @return 0 when `journal` is ready; -1 on open failure.
+ */
+static int open_vote_journal(void) {
+    struct stat st;
+    if (journal && fstat(fileno(journal), &st) == 0 && st.st_nlink > 0)
+        return 0;
+    if (journal) fclose(journal);
+    journal_unsynced = 0;
+    journal = fopen(Votes_Journal_Path, "a");
+    return journal ? 0 : -1;
+}
+
+/**
+ * ? Append one ballot to the vote journal.
+ *
+ * Writes "student_username rep_username\n" to `Votes_Journal_Path` and flushes
+ * it to the OS so other readers see it immediately. The file is fsync'ed once
+ * every `VOTE_JOURNAL_SYNC_EVERY` ballots, so a vote costs O(1) I/O instead of
+ * a full rewrite of votes.txt.
+ *
+ * @param v  Vote to record.
+ * @return   0 on success; -1 on file open/write failure.
+ */
+int append_vote(const Vote *v) {
+    METRIC_START(t);
+    if (open_vote_journal() != 0) return -1;
+    int n = fprintf(journal, "%s %s\n", v->student_username, v->rep_username);
+    if (n < 0 || fflush(journal) != 0)
+        return -1;
+    METRIC_WRITTEN(n);
+    if (++journal_unsynced >= VOTE_JOURNAL_SYNC_EVERY) {
+        fsync(fileno(journal));
+        journal_unsynced = 0;
+    }
+    METRIC_STOP(MET_JOURNAL_APPEND, t);
+    return 0;
+}
+
+/**
+ * ? Append a batch of ballots to the vote journal with a single fsync.
+ *
+ * @param arr    Votes to record.
+ * @param count  Number of votes.
+ * @return       0 once every vote is durable; -1 on I/O failure.
+ *
+ * * Usage:
+ *   - Group commit in the vote daemon and batch ballot ingestion.
+ */
+int append_votes(const Vote *arr, int count) {
+    METRIC_START(t);
+    if (open_vote_journal() != 0) return -1;
+    for (int i = 0; i < count; i++) {
+        int n = fprintf(journal, "%s %s\n", arr[i].student_username, arr[i].rep_username);
+        if (n < 0) return -1;
+        METRIC_WRITTEN(n);
+    }
+    if (fflush(journal) != 0 || fsync(fileno(journal)) != 0) return -1;
+    journal_unsynced = 0;
+    METRIC_STOP(MET_JOURNAL_APPEND, t);
+    return 0;
+}
+
+/**
+ * ? Read the ballots appended to the vote journal after byte `*offset`.
+ *
+ * Only complete lines are taken and `*offset` moves past the last one, so
+ * a ballot still being written is picked up by the next call. Malformed
+ * lines are skipped silently here; the next full load reports them with
+ * their line number.
+ *
+ * @param[in,out] offset  Journal bytes already read; a line boundary past
+ *                        the "#base N" header.
+ * @param[out] out        Allocated Vote array (caller frees).
+ * @return                Number of ballots read; -1 if the journal cannot
+ *                        be read or memory runs out.
+ *
+ * * Usage:
+ *   - state_refresh(), to absorb ballots from other terminals without
+ *     reloading the whole log.
+ */
+int load_journal_tail(long long *offset, Vote **out) {
+    METRIC_START(t);
+    *out = NULL;
+    LineReader r;
+    if (line_reader_open_at(&r, Votes_Journal_Path, *offset) != 0) return -1;
+    VoteArray a = {0};
+    int failed = 0;
+    const char *line;
+    size_t len;
+    while (!failed && (line = line_reader_next(&r, &len))) {
+        if (r.buf[r.pos - 1] != '\n') break;  // still being written
+        Field f[2];
+        Vote v;
+        int n = line_fields(line, len, f, 2);
+        if (n > 0 && !vote_from_fields(f, n, &v)) failed = append_to_array(&v, &a);
+        if (!failed) *offset = line_reader_offset(&r);
+    }
+    line_reader_close(&r);
+    METRIC_STOP(MET_LOAD_VOTES, t);
+    if (failed) {
+        free(a.arr);
+        return -1;
+    }
+    *out = a.arr;
+    return a.cnt;
+}
+
+/**
+ * ? Make pending journal entries durable and close the journal.
+ *
+ * * Usage:
+ *   - Called on exit and before compaction.
+ */
+void flush_vote_journal(void) {
+    if (!journal) return;
+    fflush(journal);
+    fsync(fileno(journal));
+    fclose(journal);
+    journal = NULL;
+    journal_unsynced = 0;
+}
+
+/**
+ * ? Whether the vote journal holds any ballot after its "#base N" header.
+ *
+ * Stops at the first ballot, so this reads at most one block.
+ */
+static bool journal_has_entries(void) {
+    LineReader r;
+    if (line_reader_open(&r, Votes_Journal_Path) != 0) return false;
+    bool found = false;
+    const char *line;
+    size_t len;
+    while (!found && (line = line_reader_next(&r, &len))) {
+        Field f[1];
+        if (line_fields(line, len, f, 1) == 0) continue;
+        found = !(r.lineNo == 1 && f[0].len == 5 && memcmp(f[0].p, "#base", 5) == 0);
+    }
+    line_reader_close(&r);
+    return found;
+}
+
+/**
+ * ? Fold the vote journal back into the votes.txt snapshot.
+ *
+ * - Loads snapshot + journal, rewrites `Votes_Path` with every vote.
+ * - Resets the journal to a single "#base N" line, N being the new
+ *   snapshot size, so a crash between both steps never double-counts.
+ * - Does nothing when the journal holds no ballots: votes.txt keeps its
+ *   inode and mtime, so running instances do not reload it.
+ *
+ * @return 0 on success; -1 on failure.
+ *
+ * * Usage:
+ *   - Called at startup and after results are published.
+ */
+int compact_votes(void) {
+    flush_vote_journal();
+    if (!journal_has_entries()) return 0;
+
+    Vote *votes = NULL;
+    int n = load_votes(&votes);
+    int result = save_votes(votes, n);
+    free(votes);
+    if (result != 0) return -1;
+
+    AtomicFile af;
+    if (atomic_file_open(&af, Votes_Journal_Path, "w") != 0) return -1;
+    fprintf(af.f, "#base %d\n", n);
+    return atomic_file_commit(&af);
+}
+
+/**
+ * ? Visit every vote (snapshot, then journal) without building a Vote array.
+ *
+ * Reads the text files one block at a time with the same parser and
+ * "#base N" rule as load_votes(), so both always agree; memory does not
+ * grow with the number of votes.
+ *
+ * @param fn   Callback; return non-zero to stop.
+ * @param ctx  Passed through to `fn`.
+ * @return     Number of votes visited.
+ */
+int scan_votes(VoteVisitor fn, void *ctx) {
+    int seen = 0;
+    if (!visit_vote_file(Votes_Path, &seen, fn, ctx))
+        visit_vote_file(Votes_Journal_Path, &seen, fn, ctx);
+    return seen;
 }
 
 /**
  * ? Save final vote tally results to disk.
  *
- * Writes each manifesto's rep_username and vote count separated by space.
+ * Writes a "#epoch N" header, then each manifesto's rep_username and vote
+ * count separated by space.
  *
  * @param mfs      Array of Manifesto entries.
  * @param counts   Corresponding vote counts.
  * @param mfCount  Number of entries.
- * @return         0 on success; -1 on file open failure.
+ * @param epoch    Number of votes (a prefix of the vote log) the counts cover.
+ * @return         0 on success; -1 on write failure (`Results_Path` untouched).
  */
-int save_results(const Manifesto *mfs, const int *counts, int mfCount) {
-    FILE *f = fopen(Results_Path, "w");
-    if (!f) return -1;
+int save_results(const Manifesto *mfs, const int *counts, int mfCount, int epoch) {
+    METRIC_START(t);
+    AtomicFile af;
+    if (atomic_file_open(&af, Results_Path, "w") != 0) return -1;
+    fprintf(af.f, "#epoch %d\n", epoch);
     for (int i = 0; i < mfCount; i++)
-        fprintf(f, "%s %d\n", mfs[i].rep_username, counts[i]);
-    fclose(f); return 0;
+        fprintf(af.f, "%s %d\n", mfs[i].rep_username, counts[i]);
+    int rc = atomic_file_commit(&af);
+    METRIC_STOP(MET_SAVE_RESULTS, t);
+    return rc;
 }
 
 /**
  * ? Load published results from disk.
  *
  * Reads each line formatted "rep_username count" from `Results_Path`,
- * generating separate arrays for manifestos and vote counts.
+ * generating separate arrays for manifestos and vote counts. A leading
+ * "#epoch N" line gives the number of votes the counts cover; files
+ * written before it existed have no header. The file is read in large
+ * blocks; malformed lines are reported with their line number and skipped.
  *
  * @param[out] outMfs     Manifesto array (rep_username only).
  * @param[out] outCounts  Parallel array of vote counts.
+ * @param[out] outEpoch   Votes covered, or -1 if unknown. May be NULL.
  * @return                Number of records loaded (0 if none or file missing).
  *
  * @pre Caller must free both `*outMfs` and `*outCounts`.
  */
-int load_results(Manifesto **outMfs, int **outCounts) {
-    FILE *f = fopen(Results_Path, "r");
-    //! correction
-    if (!f) {
+int load_results(Manifesto **outMfs, int **outCounts, int *outEpoch) {
+    METRIC_START(t);
+    if (outEpoch) *outEpoch = -1;
     *outMfs = NULL;
     *outCounts = NULL;
-    return 0;
-    }
+    LineReader r;
+    if (line_reader_open(&r, Results_Path) != 0) return 0;
     Manifesto *mfs = NULL; int *cnts = NULL;
     int cap = 0, n = 0;
-    while (!feof(f)) {
-        char uname[32]; int c;
-        if (fscanf(f, "%31s %d\n", uname, &c) != 2) break;
+    const char *line;
+    size_t len;
+    while ((line = line_reader_next(&r, &len))) {
+        Field f[2];
+        int nf = line_fields(line, len, f, 2);
+        if (nf == 0) continue;
+        if (f[0].len == 6 && memcmp(f[0].p, "#epoch", 6) == 0) {
+            int epoch;
+            if (nf == 2 && field_int(f[1], &epoch) == 0 && outEpoch) *outEpoch = epoch;
+            continue;
+        }
+        char uname[USERNAME_LEN]; int c;
+        if (nf != 2 || field_copy(f[0], uname, USERNAME_LEN) != 0 || field_int(f[1], &c) != 0) {
+            skip_bad_line(Results_Path, r.lineNo, "expected \"rep_username count\"");
+            continue;
+        }
         if (n == cap) {
-            cap = cap ? cap*2 : 4;
+            cap = cap ? cap*2 : 16;
             mfs = realloc(mfs, cap * sizeof *mfs);
             cnts = realloc(cnts, cap * sizeof *cnts);
         }
@@ -236,50 +750,131 @@ int load_results(Manifesto **outMfs, int **outCounts) {
         cnts[n] = c;
         n++;
     }
-    fclose(f); *outMfs = mfs; *outCounts = cnts; return n;
+    line_reader_close(&r);
+    METRIC_STOP(MET_LOAD_RESULTS, t);
+    *outMfs = mfs; *outCounts = cnts; return n;
 }
 
 /**
- * ? Ensure every rep has a manifesto entry.
+ * ? Persist the live tally next to the vote log.
  *
- * - Loads current reps and manifestos.
+ * Writes a "#votes N last_student" header, N being the number of votes the
+ * counts cover and last_student the voter of vote N (or "-"), followed by
+ * one "rep_username count" line per candidate.
+ *
+ * @param t          Tally to save.
+ * @param log        The vote log the tally was counted from (all of it).
+ * @return           0 on success; -1 on write failure (old file kept).
+ */
+int save_tallies(const Tally *t, const VoteLog *log) {
+    AtomicFile af;
+    if (atomic_file_open(&af, Tallies_Path, "w") != 0) return -1;
+    fprintf(af.f, "#votes %d %s\n", log->count,
+            log->count > 0 ? vote_log_student(log, log->count - 1) : "-");
+    for (int i = 0; i < t->count; i++)
+        fprintf(af.f, "%s %d\n", t->names[i], t->counts[i]);
+    return atomic_file_commit(&af);
+}
+
+/**
+ * ? Load saved tally counts for the current vote log.
+ *
+ * The saved counts are only accepted if they cover a prefix of `log`
+ * (N <= log->count and vote N was cast by the recorded student). Candidates
+ * already in `t` get their saved count; names not in `t` are ignored.
+ *
+ * @param t          Tally with its candidates added and all counts at zero.
+ * @param log        Current vote log.
+ * @return           Number of votes the loaded counts cover (the caller
+ *                   counts the rest); -1 if the file is missing, stale or
+ *                   damaged (counts in `t` are then unspecified).
+ */
+int load_tallies(Tally *t, const VoteLog *log) {
+    LineReader r;
+    if (line_reader_open(&r, Tallies_Path) != 0) return -1;
+    const char *line;
+    size_t len;
+    Field f[3];
+    int covered = -1;
+    char last[USERNAME_LEN];
+    line = line_reader_next(&r, &len);
+    if (line && line_fields(line, len, f, 3) == 3 &&
+        f[0].len == 6 && memcmp(f[0].p, "#votes", 6) == 0 &&
+        field_int(f[1], &covered) == 0 && field_copy(f[2], last, USERNAME_LEN) == 0 &&
+        covered >= 0 && covered <= log->count &&
+        strcmp(last, covered > 0 ? vote_log_student(log, covered - 1) : "-") == 0) {
+        while ((line = line_reader_next(&r, &len))) {
+            int nf = line_fields(line, len, f, 2);
+            if (nf == 0) continue;
+            char uname[USERNAME_LEN]; int c;
+            //! a damaged count line makes the whole file untrustworthy
+            if (nf != 2 || field_copy(f[0], uname, USERNAME_LEN) != 0 || field_int(f[1], &c) != 0) {
+                covered = -1;
+                break;
+            }
+            int id = name_index_get(&t->ids, uname);
+            if (id >= 0) t->counts[id] = c;
+        }
+    } else {
+        covered = -1;
+    }
+    line_reader_close(&r);
+    return covered;
+}
+
+/**
+ * ? Ensure every rep in `users` has a manifesto entry.
+ *
+ * - Loads current manifestos and indexes them by rep username in a hash
+ *   table (O(users + manifestos), no nested scan).
  * - Syncs entries: carries over existing manifestos, and for absent reps,
  *   adds placeholder "Not yet submitted".
- * - Saves the updated list to disk.
+ * - Saves the updated list only if it differs from the file's content.
+ *
+ * @param users  Users already in memory (non-reps are skipped).
+ * @param count  Number of entries.
  *
  * *Usage:
- *   - Keeps manifesto records consistent after reps register/unregister.
+ *   - Startup integrity pass, roster import and rep registration, which
+ *     all have the users (or just the reps) in memory already.
  */
-void sync_manifestos_with_reps(void) {
-    User *reps = NULL;
-    int repCount = load_reps(&reps);
-
+void sync_manifestos_with_users(const User *users, int count) {
     Manifesto *mfs = NULL;
     int mfCount = load_manifestos(&mfs);
 
-    Manifesto *updated = malloc((repCount) * sizeof(Manifesto));
-    int updCount = 0;
+    NameIndex byRep = {0};
+    Manifesto *updated = malloc((count ? count : 1) * sizeof(Manifesto));
+    if (!updated || name_index_init(&byRep, mfCount) != 0) {
+        fprintf(stderr, "[ERROR] Out of memory while syncing manifestos.\n");
+        goto cleanup;
+    }
+    for (int j = 0; j < mfCount; j++)
+        if (name_index_get(&byRep, mfs[j].rep_username) < 0)  // first entry wins
+            name_index_put(&byRep, mfs[j].rep_username, j);
 
-    for (int i = 0; i < repCount; i++) {
-        const char *repName = reps[i].username;
-        int found = 0;
-        for (int j = 0; j < mfCount; j++) {
-            if (strcmp(mfs[j].rep_username, repName) == 0) {
-                updated[updCount++] = mfs[j];
-                found = 1;
-                break;
-            }
-        }
-        if (!found) {
-            strcpy(updated[updCount].rep_username, repName);
-            strcpy(updated[updCount].manifesto, "Not yet submitted");
-            updCount++;
+    //* unchanged only if every rep maps to the manifesto at the same position
+    int repCount = 0;
+    bool changed = false;
+    for (int i = 0; i < count; i++) {
+        if (users[i].role != ROLE_REP) continue;
+        int j = name_index_get(&byRep, users[i].username);
+        Manifesto *m = &updated[repCount];
+        if (j >= 0) {
+            *m = mfs[j];
+        } else {
+            memset(m, 0, sizeof *m);
+            strcpy(m->rep_username, users[i].username);
+            strcpy(m->manifesto, "Not yet submitted");
         }
+        if (j != repCount++) changed = true;
     }
+    if (repCount != mfCount) changed = true;
 
-    save_manifestos(updated, updCount);
+    if (changed)
+        save_manifestos(updated, repCount);
 
-    free(reps);
+cleanup:
+    name_index_free(&byRep);
     free(mfs);
     free(updated);
 }
@@ -287,85 +882,106 @@ void sync_manifestos_with_reps(void) {
 /**
  * ? Display current result publication status.
  *
- * Reads the first line of `Vote_Updates_Path`:
- * - If it starts with "updated", prints that results have been published.
- * - Otherwise, indicates new votes exist and warns waiting for publishing.
- * - If file is missing or empty, displays status accordingly.
+ * Compares the vote epoch (number of ballots in the log, which only ever
+ * grows) with the epoch of the last publish; no file is read.
+ *
+ * @param voteEpoch       Ballots recorded so far.
+ * @param publishedEpoch  Ballots covered by the published results.
+ *
  * * Usage:
- *   - Called by admin to check if results are ready.
+ *   - Called by admin and students to check if results are current.
  *   - Helps avoid confusion about whether results are finalized.
  */
-void display_result_status(void) {
+void display_result_status(int voteEpoch, int publishedEpoch) {
+    if (voteEpoch <= publishedEpoch)
+        printf("[STATUS] Results have been published (updated).\n");
+    else
+        printf("[STATUS]  %d new vote(s) recorded since last update.\n[WARNING] Wait for admin to publish results.\n",
+               voteEpoch - publishedEpoch);
+}
+
+/**
+ * ? Load the published epoch from `Vote_Updates_Path`.
+ *
+ * The file holds a single "published N" line, N being the number of
+ * ballots the published results cover.
+ *
+ * @return N, or 0 if nothing has been published yet (missing or
+ *         unrecognised file).
+ */
+int load_published_epoch(void) {
     FILE *f = fopen(Vote_Updates_Path, "r");
-    if (!f) {
-        printf("[STATUS] No results file found.\n");
-        return;
-    }
-    char line[256];
-    if (fgets(line, sizeof line, f)) {
-        if (strncmp(line, "updated", 7) == 0)
-            printf("[STATUS] Results have been published (updated).\n");
-        else
-            printf("[STATUS]  New votes recorded since last update.\n[WARNING] Wait for admin to publish results.\n");
-    } else {
-        printf("[STATUS] File is empty or corrupted.\n");
-    }
+    if (!f) return 0;
+    int epoch = 0;
+    if (fscanf(f, "published %d", &epoch) != 1 || epoch < 0) epoch = 0;
     fclose(f);
+    return epoch;
+}
+
+/**
+ * ? Persist the published epoch (atomic rewrite of one short line).
+ *
+ * @param epoch  Number of ballots the published results cover.
+ * @return       0 on success; -1 on write failure.
+ */
+int save_published_epoch(int epoch) {
+    AtomicFile af;
+    if (atomic_file_open(&af, Vote_Updates_Path, "w") != 0) return -1;
+    fprintf(af.f, "published %d\n", epoch);
+    return atomic_file_commit(&af);
 }
 
 /**
  * ? Mark that results have been published.
  *
- * Overwrites `Vote_Updates_Path` with single line "updated",
- * signaling to other code that results are current.
+ * Records `epoch` as the published epoch, so results are reported as
+ * current until a ballot beyond it is cast.
+ *
+ * @param epoch  Number of ballots the just-published results cover.
+ * @return       0 on success; -1 on write failure.
  *
  * * Usage:
  *   - Called after admin publishes results.
  *   - Prevents confusion by indicating no new votes are pending.
- *   - Ensures future vote updates are appended correctly.
  */
-void mark_results_published(void) {
-    FILE *f = fopen(Vote_Updates_Path, "w");
-    if (!f) {
+int mark_results_published(int epoch) {
+    if (save_published_epoch(epoch) != 0) {
         perror("Error updating file");
-        return;
+        return -1;
     }
-    fprintf(f, "updated\n"); // only line now in file
-    fclose(f);
     printf("[ADMIN] Results marked as published. New votes will be cleared.\n");
+    return 0;
 }
 
 /**
- * ? Record a vote update to track new votes.
+ * ? Convert a pre-epoch votes_updates.txt to the "published N" format.
  *
- * Appends a line "vote_cast_by:<username>" to `Vote_Updates_Path`.
- * If file begins with "updated", it is reset before appending.
+ * The old file was a dirty flag rewritten on every ballot: "updated" right
+ * after a publish, then one "vote_cast_by:<username>" line per vote since.
+ * The published epoch is therefore the current vote count minus the number
+ * of those lines. Files already in the new format are left untouched.
  *
- * @param current  User who cast the vote (must not be NULL).
+ * @return 0 on success or nothing to do; -1 on write failure.
  *
- * *Usage:
- *   - Called after successful vote by a student.
- *   - Maintains new‑vote flag for admins to re‑publish results.
- */ 
-void append_vote_update(const User *current) {
-    FILE *f = fopen(Vote_Updates_Path, "a+");
-    if (!f) {
-        perror("Error opening votes_updates.txt");
-        return;
-    }
-
-    char first_line[256];
-    rewind(f);
-    if (fgets(first_line, sizeof first_line, f) &&
-        strncmp(first_line, "updated", 7) == 0) {
-        
-        // File starts with "updated" → clear it
-        freopen(Vote_Updates_Path, "w", f);
-    } else {
-        // Ensure writes append
-        fseek(f, 0, SEEK_END);
+ * * Usage:
+ *   - Called once at startup, under the storage lock.
+ */
+int migrate_vote_updates(void) {
+    FILE *f = fopen(Vote_Updates_Path, "r");
+    if (!f) return 0;
+    char line[256];
+    bool legacy = false;
+    int pending = 0;
+    while (fgets(line, sizeof line, f)) {
+        if (strncmp(line, "published", 9) == 0) break;
+        if (strncmp(line, "updated", 7) == 0) legacy = true;
+        else if (strncmp(line, "vote_cast_by:", 13) == 0) { legacy = true; pending++; }
     }
-
-    fprintf(f, "vote_cast_by:%s\n", current->username);
     fclose(f);
-}
\ No newline at end of file
+    if (!legacy) return 0;
+
+    Vote *votes = NULL;
+    int n = load_votes(&votes);
+    free(votes);
+    return save_published_epoch(n > pending ? n - pending : 0);
+}
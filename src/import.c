@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "import.h"
+#include "fileio.h"
+#include "utils.h"
+#include "nameindex.h"
+
+/**
+ * ? Trim leading/trailing whitespace in place.
+ */
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+/**
+ * ? Map a roster role column to a Role.
+ *
+ * @return ROLE_STUDENT / ROLE_REP, or -1 if the role is not importable
+ *         (admins are never imported).
+ */
+static int parse_role(const char *s) {
+    if (strcmp(s, "student") == 0 || strcmp(s, "2") == 0) return ROLE_STUDENT;
+    if (strcmp(s, "rep") == 0 || strcmp(s, "representative") == 0 ||
+        strcmp(s, "1") == 0) return ROLE_REP;
+    return -1;
+}
+
+/**
+ * ? Pre-register a roster of students and representatives in one pass.
+ *
+ * Streams `csv_path` line by line ("username,password,role", optional
+ * header line starting with "username"). Each row is checked with
+ * valid_username() and is_strong_password(), and deduplicated against
+ * existing accounts and earlier rows through a hash set. Rejected rows
+ * are reported with their line number.
+ *
+ * users.txt is written once at the end and the manifestos are synced a
+ * single time from the merged user list, both under the data-directory lock.
+ *
+ * @param csv_path  Roster file.
+ * @return          Number of accounts imported; -1 on I/O or memory errors.
+ *
+ * * Usage:
+ *   - `election import <roster.csv>`
+ */
+int import_roster(const char *csv_path) {
+    FILE *f = fopen(csv_path, "r");
+    if (!f) {
+        fprintf(stderr, "[ERROR] Cannot open roster %s\n", csv_path);
+        return -1;
+    }
+
+    int lock = storage_lock();
+    if (lock < 0) {
+        fprintf(stderr, "[ERROR] Cannot lock the data directory; nothing was imported.\n");
+        fclose(f);
+        return -1;
+    }
+    User *users = NULL;
+    int count = load_users(&users);
+    int cap = count;
+    NameIndex seen = {0};
+    if (name_index_init(&seen, count) != 0) goto fail;
+    for (int i = 0; i < count; i++)
+        if (name_index_put(&seen, users[i].username, i) != 0) goto fail;
+
+    char line[256];
+    int lineNo = 0, added = 0, rejected = 0, reps = 0;
+    while (fgets(line, sizeof line, f)) {
+        lineNo++;
+        char *fields[3] = {0};
+        char *p = line;
+        int n = 0;
+        while (n < 3) {
+            fields[n++] = p;
+            char *comma = strchr(p, ',');
+            if (!comma) break;
+            *comma = '\0';
+            p = comma + 1;
+        }
+        if (n == 1 && trim(fields[0])[0] == '\0') continue;  // blank line
+        if (n < 3) {
+            printf("[IMPORT] line %d: expected username,password,role\n", lineNo);
+            rejected++;
+            continue;
+        }
+        char *uname = trim(fields[0]), *pass = trim(fields[1]), *roleText = trim(fields[2]);
+        if (lineNo == 1 && strcmp(uname, "username") == 0) continue;  // header
+
+        int role = parse_role(roleText);
+        const char *why = NULL;
+        if (role < 0) why = "unknown role";
+        else if (!valid_username(uname)) why = "invalid username";
+        else if (strlen(pass) >= PASS_LEN || strchr(pass, ' ')) why = "invalid password";
+        else if (!is_strong_password(pass)) why = "weak password";
+        else if (name_index_get(&seen, uname) >= 0) why = "duplicate username";
+        if (why) {
+            printf("[IMPORT] line %d: %s (%s)\n", lineNo, why, uname);
+            rejected++;
+            continue;
+        }
+
+        if (count == cap) {
+            cap = cap ? cap * 2 : 64;
+            User *grown = realloc(users, cap * sizeof *grown);
+            if (!grown) goto fail;
+            users = grown;
+        }
+        memset(&users[count], 0, sizeof users[count]);
+        strcpy(users[count].username, uname);
+        strcpy(users[count].password, pass);
+        users[count].role = (Role)role;
+        if (name_index_put(&seen, uname, count) != 0) goto fail;
+        count++;
+        added++;
+        if (role == ROLE_REP) reps++;
+    }
+    fclose(f);
+    f = NULL;
+
+    //* one write for the whole roster; placeholders under the same lock
+    if (added > 0 && save_users(users, count) != 0) goto fail;
+    if (reps > 0) sync_manifestos_with_users(users, count);
+    storage_unlock(lock);
+    lock = -1;
+
+    printf("[SUCCESS] Imported %d account(s) (%d representative(s)); %d row(s) rejected.\n",
+           added, reps, rejected);
+    name_index_free(&seen);
+    free(users);
+    return added;
+
+fail:
+    fprintf(stderr, "[ERROR] Roster import failed.\n");
+    if (f) fclose(f);
+    storage_unlock(lock);
+    name_index_free(&seen);
+    free(users);
+    return -1;
+}
@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "ingest.h"
+#include "fileio.h"
+#include "mapview.h"
+#include "nameindex.h"
+
+// Why a ballot line was rejected (BALLOT_OK: accepted so far)
+typedef enum {
+    BALLOT_OK = 0,
+    BALLOT_MALFORMED,
+    BALLOT_UNKNOWN_STUDENT,
+    BALLOT_UNKNOWN_REP,
+    BALLOT_ALREADY_VOTED,
+    BALLOT_DUPLICATE_IN_FILE
+} BallotStatus;
+
+static const char *ballot_reason[] = {
+    "accepted", "malformed line", "not a registered student",
+    "not a registered representative", "student already voted",
+    "duplicate ballot in file"
+};
+
+// Read-only lookup sets shared by every parser thread
+typedef struct {
+    const MapView *view;
+    const NameIndex *students, *reps, *voted;
+    Vote *ballots;           // one slot per line
+    BallotStatus *status;    // one slot per line
+    int first, last;         // line range [first, last) of this chunk
+} Chunk;
+
+/**
+ * ? Copy a mapped field into a zero-padded username buffer.
+ *
+ * @return 0 on success; -1 if the field does not fit.
+ */
+static int copy_field(char *dst, const char *src, size_t len) {
+    if (len == 0 || len >= USERNAME_LEN) return -1;
+    memset(dst, 0, USERNAME_LEN);
+    memcpy(dst, src, len);
+    return 0;
+}
+
+/**
+ * ? Parse and validate one chunk of lines (thread entry point).
+ *
+ * Only reads the shared sets, so chunks run fully in parallel.
+ */
+static void *parse_chunk(void *arg) {
+    Chunk *c = arg;
+    for (int i = c->first; i < c->last; i++) {
+        size_t len, slen, rlen, extra;
+        const char *line = map_view_line(c->view, i, &len);
+        const char *student = map_view_field(line, len, 0, &slen);
+        const char *rep = map_view_field(line, len, 1, &rlen);
+        Vote *b = &c->ballots[i];
+
+        if (!student || !rep || map_view_field(line, len, 2, &extra) ||
+            copy_field(b->student_username, student, slen) != 0 ||
+            copy_field(b->rep_username, rep, rlen) != 0)
+            c->status[i] = BALLOT_MALFORMED;
+        else if (name_index_get(c->students, b->student_username) < 0)
+            c->status[i] = BALLOT_UNKNOWN_STUDENT;
+        else if (name_index_get(c->reps, b->rep_username) < 0)
+            c->status[i] = BALLOT_UNKNOWN_REP;
+        else if (name_index_get(c->voted, b->student_username) >= 0)
+            c->status[i] = BALLOT_ALREADY_VOTED;
+        else
+            c->status[i] = BALLOT_OK;
+    }
+    return NULL;
+}
+
+/**
+ * ? Merge a file of offline ballots into the vote log.
+ *
+ * 1. Maps the ballot file and splits its lines into `nthreads` chunks that
+ *    are parsed and checked in parallel against the registered students,
+ *    the registered reps and the students who already voted.
+ * 2. A sequential pass rejects repeated students within the file (first
+ *    ballot wins) and prints a report line for every rejected ballot.
+ * 3. All accepted ballots are committed with one append_votes() call,
+ *    under the data-directory lock.
+ *
+ * @param path      Ballot file, one "student rep" pair per line.
+ * @param nthreads  Number of parser threads (at least 1).
+ * @return          Number of ballots accepted; -1 on I/O or memory errors.
+ *
+ * * Usage:
+ *   - `election ingest <ballots.txt> [threads]`
+ */
+int ingest_ballots(const char *path, int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    MapView view;
+    if (map_view_open(&view, path) != 0) {
+        fprintf(stderr, "[ERROR] Cannot read ballot file %s\n", path);
+        return -1;
+    }
+
+    int lock = storage_lock();
+    if (lock < 0) {
+        fprintf(stderr, "[ERROR] Cannot lock the data directory; no ballots were recorded.\n");
+        map_view_close(&view);
+        return -1;
+    }
+    int result = -1;
+    const char *err = "Out of memory during ingest";
+    User *users = NULL;
+    Vote *votes = NULL, *accepted = NULL;
+    int userCount = load_users(&users);
+    int voteCount = load_votes(&votes);
+    NameIndex students = {0}, reps = {0}, voted = {0}, inFile = {0};
+    Vote *ballots = calloc(view.lines ? view.lines : 1, sizeof *ballots);
+    BallotStatus *status = calloc(view.lines ? view.lines : 1, sizeof *status);
+    Chunk *chunks = calloc(nthreads, sizeof *chunks);
+    pthread_t *threads = calloc(nthreads, sizeof *threads);
+    bool *spawned = calloc(nthreads, sizeof *spawned);
+    if (!ballots || !status || !chunks || !threads || !spawned ||
+        name_index_init(&students, userCount) != 0 ||
+        name_index_init(&reps, 0) != 0 ||
+        name_index_init(&voted, voteCount) != 0 ||
+        name_index_init(&inFile, view.lines) != 0)
+        goto done;
+
+    for (int i = 0; i < userCount; i++) {
+        NameIndex *set = users[i].role == ROLE_STUDENT ? &students :
+                         users[i].role == ROLE_REP ? &reps : NULL;
+        if (set && name_index_put(set, users[i].username, i) != 0) goto done;
+    }
+    for (int i = 0; i < voteCount; i++)
+        if (name_index_put(&voted, votes[i].student_username, i) != 0) goto done;
+
+    //* parallel parse + validation
+    int per = (view.lines + nthreads - 1) / nthreads;
+    for (int t = 0; t < nthreads; t++) {
+        chunks[t] = (Chunk){ &view, &students, &reps, &voted, ballots, status,
+                             t * per < view.lines ? t * per : view.lines,
+                             (t + 1) * per < view.lines ? (t + 1) * per : view.lines };
+        //* no thread to spare: parse the chunk here instead
+        spawned[t] = pthread_create(&threads[t], NULL, parse_chunk, &chunks[t]) == 0;
+        if (!spawned[t]) parse_chunk(&chunks[t]);
+    }
+    for (int t = 0; t < nthreads; t++)
+        if (spawned[t]) pthread_join(threads[t], NULL);
+
+    //* sequential pass: in-file duplicates, report, collect accepted ballots
+    accepted = malloc((view.lines ? view.lines : 1) * sizeof *accepted);
+    if (!accepted) goto done;
+    int kept = 0, rejected = 0;
+    for (int i = 0; i < view.lines; i++) {
+        if (status[i] == BALLOT_OK) {
+            if (name_index_get(&inFile, ballots[i].student_username) >= 0)
+                status[i] = BALLOT_DUPLICATE_IN_FILE;
+            else if (name_index_put(&inFile, ballots[i].student_username, i) != 0)
+                goto done;
+        }
+        if (status[i] == BALLOT_OK) {
+            accepted[kept++] = ballots[i];
+        } else {
+            size_t len;
+            const char *line = map_view_line(&view, i, &len);
+            printf("[INGEST] line %d: %s: %.*s\n", view.line_no[i], ballot_reason[status[i]], (int)len, line);
+            rejected++;
+        }
+    }
+
+    //* one append (and one fsync) for the whole file
+    if (kept > 0) {
+        if (append_votes(accepted, kept) != 0) {
+            err = "Could not write the accepted ballots";
+            goto done;
+        }
+    }
+    flush_vote_journal();
+    printf("[SUCCESS] Ingested %d ballot(s); %d rejected.\n", kept, rejected);
+    result = kept;
+
+done:
+    if (result < 0) fprintf(stderr, "[ERROR] %s; no ballots were recorded.\n", err);
+    storage_unlock(lock);
+    map_view_close(&view);
+    name_index_free(&students);
+    name_index_free(&reps);
+    name_index_free(&voted);
+    name_index_free(&inFile);
+    free(users); free(votes); free(accepted);
+    free(ballots); free(status); free(chunks); free(threads); free(spawned);
+    return result;
+}
@@ -0,0 +1,70 @@
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+
+/**
+ * ? Prepare an empty interning table.
+ *
+ * @param in        Table to initialize.
+ * @param expected  Expected number of distinct names (sizing hint).
+ * @return          0 on success; -1 on memory allocation failure.
+ */
+int intern_init(Interner *in, int expected) {
+    in->names = NULL;
+    in->count = in->cap = 0;
+    return name_index_init(&in->ids, expected);
+}
+
+/**
+ * ? Id of `name`, interning it first if it was never seen.
+ *
+ * Ids are handed out in first-seen order and never change, so arrays
+ * indexed by id stay valid as the table grows.
+ *
+ * @return The id; -1 on memory allocation failure or empty name.
+ */
+int intern_id(Interner *in, const char *name) {
+    int id = name_index_get(&in->ids, name);
+    if (id >= 0) return id;
+    if (name[0] == '\0') return -1;
+
+    if (in->count == in->cap) {
+        int cap = in->cap ? in->cap * 2 : 16;
+        char (*names)[USERNAME_LEN] = realloc(in->names, cap * sizeof *names);
+        if (!names) return -1;
+        in->names = names;
+        in->cap = cap;
+    }
+    id = in->count;
+    if (name_index_put(&in->ids, name, id) != 0) return -1;
+    memset(in->names[id], 0, USERNAME_LEN);
+    strncpy(in->names[id], name, USERNAME_LEN - 1);
+    in->count++;
+    return id;
+}
+
+/**
+ * ? Id of an already interned name.
+ *
+ * @return The id, or -1 if `name` was never interned.
+ */
+int intern_find(const Interner *in, const char *name) {
+    return name_index_get(&in->ids, name);
+}
+
+/**
+ * ? Username behind an id returned by intern_id().
+ */
+const char *intern_name(const Interner *in, uint32_t id) {
+    return in->names[id];
+}
+
+/**
+ * ? Release the memory held by an interning table.
+ */
+void intern_free(Interner *in) {
+    name_index_free(&in->ids);
+    free(in->names);
+    in->names = NULL;
+    in->count = in->cap = 0;
+}
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "linereader.h"
+#include "metrics.h"
+
+/**
+ * ? Open a text file for block-buffered line reading.
+ *
+ * @param r     Reader to initialize.
+ * @param path  File to read.
+ * @return      0 on success; -1 if the file cannot be opened or the
+ *              buffer cannot be allocated.
+ *
+ * @note Call line_reader_close() when done.
+ */
+int line_reader_open(LineReader *r, const char *path) {
+    memset(r, 0, sizeof *r);
+    r->fd = open(path, O_RDONLY);
+    if (r->fd < 0) return -1;
+    r->cap = LINE_READER_BLOCK;
+    r->buf = malloc(r->cap);
+    if (!r->buf) {
+        close(r->fd);
+        r->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * ? Open a text file for line reading from byte `offset` on.
+ *
+ * `offset` should be the start of a line, typically a value returned by
+ * line_reader_offset() on an earlier reader; lineNo counts from there.
+ *
+ * @return 0 on success; -1 if the file cannot be opened or positioned.
+ */
+int line_reader_open_at(LineReader *r, const char *path, long long offset) {
+    if (line_reader_open(r, path) != 0) return -1;
+    if (lseek(r->fd, offset, SEEK_SET) < 0) {
+        line_reader_close(r);
+        return -1;
+    }
+    r->base = offset;
+    return 0;
+}
+
+/**
+ * ? File offset just past the line last returned by line_reader_next().
+ */
+long long line_reader_offset(const LineReader *r) {
+    return r->base + (long long)r->pos;
+}
+
+/**
+ * ? Refill the buffer: keep the unread tail, read the next block after it.
+ *
+ * The buffer doubles when a single line is longer than it.
+ *
+ * @return Number of bytes read (0 at end of file); -1 on error.
+ */
+static ssize_t refill(LineReader *r) {
+    size_t tail = r->len - r->pos;
+    r->base += r->pos;
+    memmove(r->buf, r->buf + r->pos, tail);
+    r->len = tail;
+    r->pos = 0;
+    if (r->len == r->cap) {
+        char *grown = realloc(r->buf, r->cap * 2);
+        if (!grown) return -1;
+        r->buf = grown;
+        r->cap *= 2;
+    }
+    ssize_t n = read(r->fd, r->buf + r->len, r->cap - r->len);
+    if (n > 0) {
+        r->len += n;
+        METRIC_READ(n);
+    }
+    return n;
+}
+
+/**
+ * ? Next line of the file, without its "\n" (or "\r\n").
+ *
+ * The returned pointer is into the reader's buffer and stays valid until
+ * the next call. A last line without a trailing newline is returned too.
+ *
+ * @param r         Open reader.
+ * @param[out] len  Length of the line.
+ * @return          The line, or NULL at end of file (or on a read error).
+ */
+const char *line_reader_next(LineReader *r, size_t *len) {
+    for (;;) {
+        char *start = r->buf + r->pos;
+        char *nl = memchr(start, '\n', r->len - r->pos);
+        if (nl || (r->eof && r->pos < r->len)) {
+            size_t n = nl ? (size_t)(nl - start) : r->len - r->pos;
+            r->pos += nl ? n + 1 : n;
+            if (n > 0 && start[n - 1] == '\r') n--;
+            r->lineNo++;
+            *len = n;
+            return start;
+        }
+        if (r->eof) return NULL;
+        ssize_t got = refill(r);
+        if (got < 0) return NULL;
+        if (got == 0) r->eof = true;
+    }
+}
+
+/**
+ * ? Release the reader's buffer and file descriptor.
+ */
+void line_reader_close(LineReader *r) {
+    if (r->fd >= 0) close(r->fd);
+    free(r->buf);
+    r->fd = -1;
+    r->buf = NULL;
+}
+
+/**
+ * ? Split a line on spaces and tabs.
+ *
+ * @param line  Line start.
+ * @param len   Line length.
+ * @param out   Receives up to `max` fields.
+ * @param max   Capacity of `out`.
+ * @return      Number of fields in the line, counting at most one past
+ *              `max` (so callers can tell "too many" from "exactly max").
+ */
+int line_fields(const char *line, size_t len, Field *out, int max) {
+    int n = 0;
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && (line[i] == ' ' || line[i] == '\t')) i++;
+        if (i == len) break;
+        size_t start = i;
+        while (i < len && line[i] != ' ' && line[i] != '\t') i++;
+        if (n == max) return max + 1;
+        out[n].p = line + start;
+        out[n].len = i - start;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * ? Parse a field as a decimal int (optional leading '-').
+ *
+ * @return 0 on success; -1 if the field is empty, has other characters,
+ *         or overflows an int.
+ */
+int field_int(Field f, int *out) {
+    size_t i = 0;
+    bool neg = f.len > 0 && f.p[0] == '-';
+    if (neg) i++;
+    if (i == f.len) return -1;
+    long long v = 0;
+    for (; i < f.len; i++) {
+        if (f.p[i] < '0' || f.p[i] > '9') return -1;
+        v = v * 10 + (f.p[i] - '0');
+        if (v > INT_MAX) return -1;
+    }
+    *out = (int)(neg ? -v : v);
+    return 0;
+}
+
+/**
+ * ? Copy a field into a fixed-size, zero-padded buffer.
+ *
+ * @return 0 on success; -1 if the field (plus terminator) does not fit.
+ */
+int field_copy(Field f, char *dst, size_t size) {
+    if (f.len >= size) return -1;
+    memcpy(dst, f.p, f.len);
+    memset(dst + f.len, 0, size - f.len);
+    return 0;
+}
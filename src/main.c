@@ -7,6 +7,16 @@
 #include "admin.h"
 #include "rep.h"
 #include "student.h"
+#include "state.h"
+#include "server.h"
+#include "client.h"
+#include "import.h"
+#include "ingest.h"
+#include "metrics.h"
+#include "batch.h"
+#include "export.h"
+#include <unistd.h>
+#include <sys/stat.h>
 
 //! the roles :
 //? 0 == admin
@@ -20,8 +30,13 @@ void Welcoming_message()
     printf("• This system allows you to:\n    • Login as the admin.\n    • Register/login as a student.\n    • Register/login as representative.\n\n");
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
+    //* scripted commands: stdout carries only their replies
+    bool batch = argc > 1 && batch_is_command(argv[1]);
+    if (batch)
+        batch_begin();
+
     //! ensure files exist or create them
     ensure_file_exists(Users_Path);
     ensure_file_exists(Manifesto_Path);
@@ -29,20 +44,69 @@ int main(void)
     ensure_file_exists(Results_Path);
     ensure_file_exists(Vote_Updates_Path);
 
-    //* for initializin the admin account
-        initial_admin_setup();
-    //* check if the default admin is at the top of the users file
-        if (check_default_admin_at_top() == 0) {
-            printf("\n[ERROR] Default admin is not at the top of the users file.\n");
-            enforce_default_admin_top();
-            printf("[SUCCESS] Default admin is now at the top of the users file.\n");
-        }
-    //* clean other admins except the default one
-        verify_and_clean_admins();
-    //* sync_manifestos_with_reps()
-        sync_manifestos_with_reps(); //! in case the representatives was entered manually
+    //* `election export csv|json [file]`: read-only and streamed, so it
+    //* skips the startup passes that load whole files
+    if (argc > 1 && strcmp(argv[1], "export") == 0)
+        return export_command(argc - 1, argv + 1);
+
+    //* fold a large vote journal into votes.txt (small ones are replayed on
+    //* load, so a one-shot command stays O(1)) and convert an old-style
+    //* votes_updates.txt to the published epoch
+    int lock = storage_lock();
+    if (lock < 0) {
+        fprintf(stderr, "[ERROR] Cannot lock the data directory.\n");
+        return EXIT_FAILURE;
+    }
+    struct stat journalStat;
+    if (stat(Votes_Journal_Path, &journalStat) == 0 && journalStat.st_size > VOTE_JOURNAL_COMPACT_BYTES)
+        compact_votes();
+    migrate_vote_updates();
+    storage_unlock(lock);
+
+    //* one pass over users.txt: default admin on top, no stray admins, a
+    //* manifesto for every rep (in case the representatives were entered manually)
+    if (startup_integrity_pass() != 0)
+        fprintf(stderr, "[ERROR] Startup integrity checks failed.\n");
+    //* `election import <roster.csv>`: bulk pre-registration, no menus
+    if (argc > 2 && strcmp(argv[1], "import") == 0)
+        return import_roster(argv[2]) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    //* `election ingest <ballots.txt> [threads]`: merge offline ballots, no menus
+    if (argc > 2 && strcmp(argv[1], "ingest") == 0) {
+        int threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        return ingest_ballots(argv[2], threads) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    //* load the whole election once; menus work from memory from now on
+    ElectionState st = {0};
+    if (state_load(&st) != 0) {
+        fprintf(stderr, "[ERROR] Out of memory while loading the election.\n");
+        return EXIT_FAILURE;
+    }
+    //* `election vote|publish|tally|batch|convert ...`: no menus or banners
+    if (batch) {
+        int before = st.log.count;
+        int rc = batch_run(&st, argc - 1, argv + 1);
+        flush_vote_journal();
+        if (st.log.count != before)
+            save_tallies(&st.tally, &st.log);
+        metrics_finish();
+        state_free(&st);
+        return rc;
+    }
+    //* `election serve [threads]`: run the vote daemon instead of the menus
+    if (argc > 1 && strcmp(argv[1], "serve") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        int rc = server_run(&st, Server_Socket_Path, threads);
+        flush_vote_journal();
+        metrics_finish();
+        save_tallies(&st.tally, &st.log);
+        state_free(&st);
+        return rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    //* terminals hand logins and ballots to the vote daemon when one runs
+    if (client_detect(Server_Socket_Path))
+        printf("[INFO] Connected to the vote daemon.\n");
     //* Welcome message
-        Welcoming_message();
+    Welcoming_message();
     printf("=================================================\n");
 
     //* Main loop
@@ -51,6 +115,7 @@ int main(void)
         int opt = main_prompt();
         if (opt == 0)
             break;
+        metrics_maybe_flush();
 
         /** @note: Check if the default admin is at the top of the users file ( avoiding corrupted data ) **/
         if (check_default_admin_at_top() == 0) {
@@ -87,21 +152,23 @@ int main(void)
             printf("\n[SUCCESS] Password accepted\n\n");
 
             //! Authenticate user
-            verify_and_clean_admins(); // Ensure admin is at the top and no duplicates
-            if (authenticate(uname, pass, &current))
+            state_refresh(&st);
+            int auth = client_active() ? client_login(uname, pass, &current) : -1;
+            if (auth < 0) auth = authenticate(&st.users, uname, pass, &current);
+            if (auth)
             {
                 if (current.role == ROLE_ADMIN)
                 {
                     printf("[ADMIN] Admin login successful.\n");
-                    admin_menu(&current);
+                    admin_menu(&st, &current);
                 }
                 else if (current.role == ROLE_REP)
                 {
-                    rep_menu(&current);
+                    rep_menu(&st, &current);
                 }
                 else
                 {
-                    student_menu(&current);
+                    student_menu(&st, &current);
                 }
             }
             else
@@ -112,15 +179,12 @@ int main(void)
         //* Registration
         else if (opt == 1)
         {
+            state_refresh(&st);  // pick up accounts registered by other instances
             // 1. Choose role
             printf("\nChoose to register as:\n 1. Student Representative\n 2. Student\nSelect (1–2): ");
             int role_choice = get_int(1, 2);
 
-            // 2. Load existing users and add new one
-            User *users = NULL;
-            int cnt = load_users(&users);
-
-            // 3. Get base credentials
+            // 2. Get base credentials
             //! checking user name availibility in a loop
             bool taken = true;
             printf("\nEnter The:\n");
@@ -128,7 +192,7 @@ int main(void)
             {
                 get_string("Username", uname, USERNAME_LEN);
                 //! Already taken
-                if (username_exists(users, cnt, uname))
+                if (username_exists(&st.users, uname))
                 {
                     printf("[Att] Username already exists!\n");
                     continue;
@@ -161,23 +225,33 @@ int main(void)
             }
             printf("\n[SUCCESS] Password accepted\n");
 
-            users = realloc(users, (cnt + 1) * sizeof *users);
-            strcpy(users[cnt].username, uname);
-            strcpy(users[cnt].password, pass);
-            users[cnt].role = (role_choice == 1 ? ROLE_REP : ROLE_STUDENT);
+            // 3. Add the new user to the state (appends one line to users.txt)
+            User newUser;
+            strcpy(newUser.username, uname);
+            strcpy(newUser.password, pass);
+            newUser.role = (role_choice == 1 ? ROLE_REP : ROLE_STUDENT);
 
-            save_users(users, cnt + 1);
-            free(users);
+            int added = state_add_user(&st, &newUser);
+            if (added == 1) {
+                printf("\n[ERROR] Username was taken meanwhile. Please register again.\n\n");
+                continue;
+            }
+            if (added != 0) {
+                printf("\n[ERROR] Could not save the new account.\n\n");
+                continue;
+            }
 
             printf("\n[SUCCESS] Registration complete! You are now a %s.\n\n",
             role_choice == 1 ? "STUDENT REPRESENTATIVE" : "STUDENT");
-            // sync manifestos with reps
-            if (role_choice == 1) {
-                sync_manifestos_with_reps();
+            //* state_add_user already gave a new rep its manifesto placeholder
+            if (role_choice == 1)
                 printf("\n[SUCCESS] Manifestos synced with representatives.\n\n");
-            }
         }
     }
+    flush_vote_journal();
+    save_tallies(&st.tally, &st.log);
+    metrics_finish();
+    state_free(&st);
     printf("\n[Waiting] Exiting, goodbye!\n");
     return 0;
 }
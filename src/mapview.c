@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mapview.h"
+#include "metrics.h"
+
+/**
+ * ? Map a text file read-only and index its lines.
+ *
+ * The contents are never copied: callers read records straight out of the
+ * page cache through map_view_line() / map_view_field().
+ *
+ * @param v     View to fill.
+ * @param path  File to map.
+ * @return      0 on success (an empty file gives 0 lines);
+ *              -1 if the file cannot be opened, mapped or indexed.
+ *
+ * @note Call map_view_close() when done.
+ */
+int map_view_open(MapView *v, const char *path) {
+    memset(v, 0, sizeof *v);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return -1; }
+    v->size = st.st_size;
+    if (v->size == 0) { close(fd); return 0; }
+
+    void *p = mmap(NULL, v->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { v->size = 0; return -1; }
+    v->data = p;
+    METRIC_READ(v->size);
+    posix_madvise(p, v->size, POSIX_MADV_SEQUENTIAL);
+
+    int cap = 0, lineNo = 0;
+    size_t pos = 0;
+    while (pos < v->size) {
+        lineNo++;
+        const char *nl = memchr(v->data + pos, '\n', v->size - pos);
+        size_t end = nl ? (size_t)(nl - v->data) : v->size;
+        if (end > pos) {
+            if (v->lines == cap) {
+                cap = cap ? cap * 2 : 64;
+                size_t *grown = realloc(v->line_off, cap * sizeof *grown);
+                if (grown) v->line_off = grown;
+                int *grownNo = realloc(v->line_no, cap * sizeof *grownNo);
+                if (grownNo) v->line_no = grownNo;
+                if (!grown || !grownNo) { map_view_close(v); return -1; }
+            }
+            v->line_no[v->lines] = lineNo;
+            v->line_off[v->lines++] = pos;
+        }
+        pos = end + 1;
+    }
+    return 0;
+}
+
+/**
+ * ? Access line `i` of the view (without its newline).
+ *
+ * @param v         Open view.
+ * @param i         Line number, 0..lines-1.
+ * @param[out] len  Length of the line in bytes.
+ * @return          Pointer into the mapping (not null-terminated).
+ */
+const char *map_view_line(const MapView *v, int i, size_t *len) {
+    size_t start = v->line_off[i];
+    const char *nl = memchr(v->data + start, '\n', v->size - start);
+    size_t end = nl ? (size_t)(nl - v->data) : v->size;
+    if (end > start && v->data[end - 1] == '\r') end--;
+    *len = end - start;
+    return v->data + start;
+}
+
+/**
+ * ? Find the n-th whitespace-separated field of a line.
+ *
+ * @param line       Line returned by map_view_line().
+ * @param len        Its length.
+ * @param n          Field number, starting at 0.
+ * @param[out] flen  Length of the field.
+ * @return           Pointer to the field, or NULL if the line has fewer fields.
+ */
+const char *map_view_field(const char *line, size_t len, int n, size_t *flen) {
+    size_t i = 0;
+    for (;;) {
+        while (i < len && (line[i] == ' ' || line[i] == '\t')) i++;
+        if (i == len) return NULL;
+        size_t start = i;
+        while (i < len && line[i] != ' ' && line[i] != '\t') i++;
+        if (n-- == 0) {
+            *flen = i - start;
+            return line + start;
+        }
+    }
+}
+
+/**
+ * ? Unmap the file and free the line index.
+ */
+void map_view_close(MapView *v) {
+    if (v->data) munmap((void *)v->data, v->size);
+    free(v->line_off);
+    free(v->line_no);
+    memset(v, 0, sizeof *v);
+}
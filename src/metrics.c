@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "metrics.h"
+#include "atomicfile.h"
+
+/**
+ * ? Name of this process's metrics file.
+ *
+ * The daemon and every terminal share a data directory, so each process
+ * writes its own metrics.<pid>.prom instead of replacing a common file;
+ * the textfile collector merges them and sum() aggregates across writers.
+ * metrics_finish() removes the file when the process exits.
+ *
+ * @return  Path built from Metrics_Path_Format; valid for the process lifetime.
+ */
+const char *metrics_path(void) {
+    static char path[32];
+    if (path[0] == '\0') snprintf(path, sizeof path, Metrics_Path_Format, (long)getpid());
+    return path;
+}
+
+/**
+ * ? Remove this process's metrics file on exit.
+ *
+ * Counters of a process that is gone would otherwise stay in every scrape
+ * as if it were still running.
+ *
+ * * Usage:
+ *   - Last call on every exit path of main (menus, serve, batch).
+ */
+void metrics_finish(void) {
+    unlink(metrics_path());
+}
+
+#if ENABLE_METRICS
+
+//* Counters are bumped with relaxed atomics: the vote daemon records from
+//* several threads and a dump only needs each value to be torn-free
+typedef struct {
+    uint64_t calls;
+    uint64_t ns;
+    uint64_t maxNs;
+    uint64_t buckets[METRICS_BUCKETS];
+} OpStats;
+
+static OpStats stats[MET_OP_COUNT];
+static uint64_t bytesRead, bytesWritten;
+static uint64_t lastFlushNs;
+
+static const char *const metric_names[MET_OP_COUNT] = {
+    "load_users", "load_manifestos", "load_votes", "load_results",
+    "save_users", "save_manifestos", "save_votes", "save_results",
+    "journal_append", "authenticate", "record_vote", "publish_results"
+};
+
+uint64_t metrics_clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+//* Upper bound of bucket i in nanoseconds (4^i microseconds)
+static uint64_t bucket_bound_ns(int i) {
+    return 1000ull << (2 * i);
+}
+
+/**
+ * ? Account one completed operation.
+ *
+ * @param op  Operation that finished.
+ * @param ns  Its wall time in nanoseconds.
+ */
+void metrics_record(MetricOp op, uint64_t ns) {
+    OpStats *s = &stats[op];
+    int b = 0;
+    while (b < METRICS_BUCKETS - 1 && ns > bucket_bound_ns(b)) b++;
+    __atomic_fetch_add(&s->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->buckets[b], 1, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&s->maxNs, __ATOMIC_RELAXED);
+    while (ns > max &&
+           !__atomic_compare_exchange_n(&s->maxNs, &max, ns, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void metrics_add_read(uint64_t bytes) {
+    __atomic_fetch_add(&bytesRead, bytes, __ATOMIC_RELAXED);
+}
+
+void metrics_add_written(uint64_t bytes) {
+    __atomic_fetch_add(&bytesWritten, bytes, __ATOMIC_RELAXED);
+}
+
+//* Consistent-enough copy of one operation's counters
+static OpStats snapshot(MetricOp op) {
+    OpStats s;
+    s.calls = __atomic_load_n(&stats[op].calls, __ATOMIC_RELAXED);
+    s.ns = __atomic_load_n(&stats[op].ns, __ATOMIC_RELAXED);
+    s.maxNs = __atomic_load_n(&stats[op].maxNs, __ATOMIC_RELAXED);
+    for (int b = 0; b < METRICS_BUCKETS; b++)
+        s.buckets[b] = __atomic_load_n(&stats[op].buckets[b], __ATOMIC_RELAXED);
+    return s;
+}
+
+/**
+ * ? Print every operation's call count and latency, plus the I/O totals.
+ *
+ * Percentiles are read off the histogram, so p50/p99 are the upper bound
+ * of the bucket they fall in.
+ *
+ * @param out  Stream to print to (the admin menu passes stdout).
+ */
+void metrics_print(FILE *out) {
+    fprintf(out, "%-16s %10s %12s %12s %12s %12s\n",
+            "operation", "calls", "mean_us", "p50_us<=", "p99_us<=", "max_us");
+    for (int op = 0; op < MET_OP_COUNT; op++) {
+        OpStats s = snapshot(op);
+        if (s.calls == 0) continue;
+        double pct[2] = {0.50, 0.99};
+        char cell[2][24];
+        for (int k = 0; k < 2; k++) {
+            uint64_t need = (uint64_t)(pct[k] * s.calls + 0.999999), seen = 0;
+            int b = 0;
+            while (b < METRICS_BUCKETS - 1 && (seen += s.buckets[b]) < need) b++;
+            if (b == METRICS_BUCKETS - 1) snprintf(cell[k], sizeof cell[k], "inf");
+            else snprintf(cell[k], sizeof cell[k], "%llu", (unsigned long long)(bucket_bound_ns(b) / 1000));
+        }
+        fprintf(out, "%-16s %10llu %12.1f %12s %12s %12.1f\n", metric_names[op],
+                (unsigned long long)s.calls, s.ns / 1e3 / s.calls, cell[0], cell[1], s.maxNs / 1e3);
+    }
+    fprintf(out, "bytes read: %llu, bytes written: %llu\n",
+            (unsigned long long)__atomic_load_n(&bytesRead, __ATOMIC_RELAXED),
+            (unsigned long long)__atomic_load_n(&bytesWritten, __ATOMIC_RELAXED));
+}
+
+/**
+ * ? Write all metrics in the Prometheus text exposition format.
+ *
+ * One histogram family (election_op_duration_seconds, labelled by op) and
+ * two byte counters. Series carry the writer's pid so the per-process
+ * files never expose the same series twice. The file is replaced atomically, so a scraper (e.g.
+ * node_exporter's textfile collector) never reads half of it.
+ *
+ * @param path  Output file, usually metrics_path().
+ * @return      0 on success; -1 on write failure.
+ */
+int metrics_write_prometheus(const char *path) {
+    AtomicFile af;
+    if (atomic_file_open(&af, path, "w") != 0) return -1;
+    long pid = (long)getpid();
+    fprintf(af.f, "# HELP election_op_duration_seconds Wall time of storage, login, vote and publish operations.\n");
+    fprintf(af.f, "# TYPE election_op_duration_seconds histogram\n");
+    for (int op = 0; op < MET_OP_COUNT; op++) {
+        OpStats s = snapshot(op);
+        uint64_t cum = 0;
+        for (int b = 0; b < METRICS_BUCKETS; b++) {
+            cum += s.buckets[b];
+            if (b < METRICS_BUCKETS - 1)
+                fprintf(af.f, "election_op_duration_seconds_bucket{op=\"%s\",pid=\"%ld\",le=\"%g\"} %llu\n",
+                        metric_names[op], pid, bucket_bound_ns(b) / 1e9, (unsigned long long)cum);
+            else
+                fprintf(af.f, "election_op_duration_seconds_bucket{op=\"%s\",pid=\"%ld\",le=\"+Inf\"} %llu\n",
+                        metric_names[op], pid, (unsigned long long)cum);
+        }
+        fprintf(af.f, "election_op_duration_seconds_sum{op=\"%s\",pid=\"%ld\"} %.9f\n",
+                metric_names[op], pid, s.ns / 1e9);
+        fprintf(af.f, "election_op_duration_seconds_count{op=\"%s\",pid=\"%ld\"} %llu\n",
+                metric_names[op], pid, (unsigned long long)s.calls);
+    }
+    fprintf(af.f, "# HELP election_bytes_read_total Bytes read from disk by this process.\n");
+    fprintf(af.f, "# TYPE election_bytes_read_total counter\n");
+    fprintf(af.f, "election_bytes_read_total{pid=\"%ld\"} %llu\n", pid,
+            (unsigned long long)__atomic_load_n(&bytesRead, __ATOMIC_RELAXED));
+    fprintf(af.f, "# HELP election_bytes_written_total Bytes written to disk by this process.\n");
+    fprintf(af.f, "# TYPE election_bytes_written_total counter\n");
+    fprintf(af.f, "election_bytes_written_total{pid=\"%ld\"} %llu\n", pid,
+            (unsigned long long)__atomic_load_n(&bytesWritten, __ATOMIC_RELAXED));
+    return atomic_file_commit(&af);
+}
+
+/**
+ * ? Rewrite metrics_path() if METRICS_FLUSH_SECONDS have passed since the last write.
+ *
+ * * Usage:
+ *   - Called from the main menu loop and the vote daemon's commit loop.
+ */
+void metrics_maybe_flush(void) {
+    uint64_t now = metrics_clock();
+    uint64_t last = __atomic_load_n(&lastFlushNs, __ATOMIC_RELAXED);
+    if (last != 0 && now - last < METRICS_FLUSH_SECONDS * 1000000000ull) return;
+    __atomic_store_n(&lastFlushNs, now, __ATOMIC_RELAXED);
+    metrics_write_prometheus(metrics_path());
+}
+
+#else
+
+void metrics_print(FILE *out) {
+    fprintf(out, "[WARNING] Metrics were compiled out (ENABLE_METRICS 0).\n");
+}
+
+int metrics_write_prometheus(const char *path) {
+    (void)path;
+    return -1;
+}
+
+void metrics_maybe_flush(void) {}
+
+#endif
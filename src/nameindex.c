@@ -0,0 +1,252 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "nameindex.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NAME_INDEX_X86 1
+#include <immintrin.h>
+#else
+#define NAME_INDEX_X86 0
+#endif
+
+//* Username kernels. Keys and queries are zero-padded to USERNAME_LEN (32)
+//* bytes, so equality is one fixed-width compare and the hash reads four
+//* 64-bit words; no byte loop, no terminator search.
+typedef int (*FindFn)(const NameIndex *ix, const char *key);
+
+static inline unsigned hash_words(const char *key) {
+    uint64_t w[4];
+    memcpy(w, key, sizeof w);
+    uint64_t h = (w[0] * 0x9E3779B97F4A7C15ull) ^ (w[1] * 0xC2B2AE3D27D4EB4Full) ^
+                 (w[2] * 0x165667B19E3779F9ull) ^ (w[3] * 0xD6E8FEB86659FD93ull);
+    return (unsigned)(h ^ (h >> 29) ^ (h >> 47));
+}
+
+static inline bool eq_words(const char *a, const char *b) {
+    uint64_t x[4], y[4];
+    memcpy(x, a, sizeof x);
+    memcpy(y, b, sizeof y);
+    return ((x[0] ^ y[0]) | (x[1] ^ y[1]) | (x[2] ^ y[2]) | (x[3] ^ y[3])) == 0;
+}
+
+#if NAME_INDEX_X86
+__attribute__((target("sse2")))
+static inline bool eq_sse2(const char *a, const char *b) {
+    __m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)b));
+    __m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(a + 16)), _mm_loadu_si128((const __m128i *)(b + 16)));
+    return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xFFFF;
+}
+
+__attribute__((target("avx2")))
+static inline bool eq_avx2(const char *a, const char *b) {
+    __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)a), _mm256_loadu_si256((const __m256i *)b));
+    return _mm256_movemask_epi8(eq) == -1;
+}
+
+__attribute__((target("sse4.2")))
+static inline unsigned hash_crc32(const char *key) {
+    uint64_t w[4];
+    memcpy(w, key, sizeof w);
+    uint64_t h = _mm_crc32_u64(0, w[0]);
+    h = _mm_crc32_u64(h, w[1]);
+    h = _mm_crc32_u64(h, w[2]);
+    return (unsigned)_mm_crc32_u64(h, w[3]);
+}
+#endif
+
+/**
+ * ? Find the slot holding `key`, or the empty slot where it would go.
+ *
+ * `key` is zero-padded to USERNAME_LEN bytes. Linear probing; the table
+ * is never more than half full, so the probe always terminates on an
+ * empty slot. One copy per kernel so the hash and compare are inlined
+ * into the probe loop.
+ */
+#define DEFINE_FIND_SLOT(fn, hash, eq)                                  \
+    static int fn(const NameIndex *ix, const char *key) {               \
+        int mask = ix->cap - 1;                                         \
+        int i = hash(key) & mask;                                       \
+        while (ix->keys[i][0] != '\0' && !eq(ix->keys[i], key))         \
+            i = (i + 1) & mask;                                         \
+        return i;                                                       \
+    }
+
+DEFINE_FIND_SLOT(find_slot_scalar, hash_words, eq_words)
+#if NAME_INDEX_X86
+__attribute__((target("sse2")))
+DEFINE_FIND_SLOT(find_slot_sse2, hash_words, eq_sse2)
+__attribute__((target("avx2,sse4.2")))
+DEFINE_FIND_SLOT(find_slot_avx2, hash_crc32, eq_avx2)
+#endif
+
+static FindFn find_slot = find_slot_scalar;
+static NameIndexKernel active = NAME_KERNEL_SCALAR;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+/**
+ * ? Install the functions of kernel `k` if this CPU supports it.
+ *
+ * @return 0 on success; -1 if unsupported (current kernel kept).
+ */
+static int apply_kernel(NameIndexKernel k) {
+    if (k == NAME_KERNEL_SCALAR) {
+        find_slot = find_slot_scalar;
+        active = k;
+        return 0;
+    }
+#if NAME_INDEX_X86
+    __builtin_cpu_init();
+    if (k == NAME_KERNEL_SSE2 && __builtin_cpu_supports("sse2")) {
+        find_slot = find_slot_sse2;
+        active = k;
+        return 0;
+    }
+    if (k == NAME_KERNEL_AVX2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2")) {
+        find_slot = find_slot_avx2;
+        active = k;
+        return 0;
+    }
+#endif
+    return -1;
+}
+
+//* Best kernel first; scalar always succeeds
+static void pick_kernel(void) {
+    if (apply_kernel(NAME_KERNEL_AVX2) != 0 && apply_kernel(NAME_KERNEL_SSE2) != 0)
+        apply_kernel(NAME_KERNEL_SCALAR);
+}
+
+/**
+ * ? Select the compare/hash kernels used by every index.
+ *
+ * The best kernel the CPU supports is picked automatically on the first
+ * name_index_init(); this override exists for benchmarks. The hash
+ * differs between kernels, so it must be called before any index is
+ * built (or after all of them are freed).
+ *
+ * @param k  Kernel to use; NAME_KERNEL_AUTO re-runs the CPU detection.
+ * @return   0 on success; -1 if the CPU or the build does not support `k`.
+ */
+int name_index_use_kernel(NameIndexKernel k) {
+    pthread_once(&kernel_once, pick_kernel);
+    if (k == NAME_KERNEL_AUTO) {
+        pick_kernel();
+        return 0;
+    }
+    return apply_kernel(k);
+}
+
+/**
+ * ? Name of the kernel in use ("scalar", "sse2" or "avx2").
+ */
+const char *name_index_kernel(void) {
+    pthread_once(&kernel_once, pick_kernel);
+    static const char *names[] = { "auto", "scalar", "sse2", "avx2" };
+    return names[active];
+}
+
+/**
+ * ? Allocate an empty index sized for `expected` keys.
+ *
+ * @param ix        Index to initialize.
+ * @param expected  Number of keys the caller plans to insert (may be 0).
+ * @return          0 on success; -1 on memory allocation failure.
+ */
+int name_index_init(NameIndex *ix, int expected) {
+    pthread_once(&kernel_once, pick_kernel);
+    int cap = 16;
+    while (cap < expected * 2) cap *= 2;
+    //* cache-line aligned: a 32-byte key never straddles two lines
+    ix->keys = aligned_alloc(64, cap * sizeof *ix->keys);
+    if (ix->keys) memset(ix->keys, 0, cap * sizeof *ix->keys);
+    ix->values = malloc(cap * sizeof *ix->values);
+    ix->cap = cap;
+    ix->count = 0;
+    if (!ix->keys || !ix->values) {
+        name_index_free(ix);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * ? Double the table and re-insert every key.
+ *
+ * @return 0 on success; -1 on memory allocation failure (index unchanged).
+ */
+static int grow(NameIndex *ix) {
+    NameIndex bigger;
+    if (name_index_init(&bigger, ix->cap) != 0) return -1;
+    for (int i = 0; i < ix->cap; i++) {
+        if (ix->keys[i][0] == '\0') continue;
+        int slot = find_slot(&bigger, ix->keys[i]);
+        memcpy(bigger.keys[slot], ix->keys[i], USERNAME_LEN);
+        bigger.values[slot] = ix->values[i];
+    }
+    bigger.count = ix->count;
+    name_index_free(ix);
+    *ix = bigger;
+    return 0;
+}
+
+/**
+ * ? Look up the value stored for `name`.
+ *
+ * @return The stored value, or -1 if `name` is not in the index.
+ */
+int name_index_get(const NameIndex *ix, const char *name) {
+    return name_index_get_n(ix, name, strlen(name));
+}
+
+/**
+ * ? Look up a name given as a (pointer, length) pair.
+ *
+ * Lets callers search with a field that points into a larger buffer
+ * (e.g. a memory-mapped line) without copying it out first.
+ *
+ * @return The stored value, or -1 if the name is not in the index.
+ */
+int name_index_get_n(const NameIndex *ix, const char *name, size_t len) {
+    if (!ix->keys || len == 0 || len >= USERNAME_LEN) return -1;
+    _Alignas(32) char key[USERNAME_LEN] = {0};
+    memcpy(key, name, len);
+    int slot = find_slot(ix, key);
+    return ix->keys[slot][0] ? ix->values[slot] : -1;
+}
+
+/**
+ * ? Insert `name` with `value`, or overwrite the value if already present.
+ *
+ * A zero-initialized NameIndex is accepted and allocated on first insert.
+ *
+ * @return 0 on success; -1 on memory allocation failure or empty name.
+ */
+int name_index_put(NameIndex *ix, const char *name, int value) {
+    if (name[0] == '\0') return -1;
+    if (!ix->keys && name_index_init(ix, 0) != 0) return -1;
+    if ((ix->count + 1) * 2 > ix->cap && grow(ix) != 0) return -1;
+    _Alignas(32) char key[USERNAME_LEN] = {0};
+    memcpy(key, name, strnlen(name, USERNAME_LEN - 1));
+    int slot = find_slot(ix, key);
+    if (ix->keys[slot][0] == '\0') {
+        memcpy(ix->keys[slot], key, USERNAME_LEN);
+        ix->count++;
+    }
+    ix->values[slot] = value;
+    return 0;
+}
+
+/**
+ * ? Release the memory held by an index.
+ */
+void name_index_free(NameIndex *ix) {
+    free(ix->keys);
+    free(ix->values);
+    ix->keys = NULL;
+    ix->values = NULL;
+    ix->cap = ix->count = 0;
+}
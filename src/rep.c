@@ -11,7 +11,7 @@ void Representative_actions(){
     printf(" • Submit/update their election manifesto.\n");
 }
 
-void rep_menu(const User *current) {
+void rep_menu(ElectionState *st, const User *current) {
     printf("\n=================================================");
     printf("\n      [Welcome] Representative: %s\n", current->username);
     printf("=================================================\n");
@@ -27,23 +27,21 @@ void rep_menu(const User *current) {
             logging_out();
             break;
         }
-
-        Manifesto *mfs = NULL;
-        int mfCount = load_manifestos(&mfs);
+        state_refresh(st);
 
         int idx = -1;
-        for (int i = 0; i < mfCount; i++) {
-            if (strcmp(mfs[i].rep_username, current->username) == 0) {
+        for (int i = 0; i < st->mfCount; i++) {
+            if (strcmp(st->mfs[i].rep_username, current->username) == 0) {
                 idx = i;
                 break;
             }
         }
         //* Get the manifesto content from the user
         if (idx >= 0) {
-            if (strcmp(mfs[idx].manifesto, "Not yet submitted") == 0) {
+            if (strcmp(st->mfs[idx].manifesto, "Not yet submitted") == 0) {
                 printf("\n\n[WARNING] You have not submitted a manifesto yet.\n\n");
             } else {
-                printf("\n\nCurrent manifesto:\n%s\n", mfs[idx].manifesto);
+                printf("\n\nCurrent manifesto:\n%s\n", st->mfs[idx].manifesto);
             }
         }
         
@@ -54,18 +52,13 @@ void rep_menu(const User *current) {
                 printf("\n[WARNING] No changes made to the manifesto.\n");
                 continue; // No changes, prompt again
         }
-        else if (idx >= 0 && buffer[0] != '\0') {
-            strcpy(mfs[idx].manifesto, buffer);
+        //* write-through: updates memory and manifestos.txt
+        if (state_set_manifesto(st, current->username, buffer) != 0) {
+            printf("\n[ERROR] Could not save the manifesto.\n");
+        } else if (idx >= 0) {
             printf("\n[SUCCESS] Manifesto updated.\n");
         } else {
-            mfs = realloc(mfs, (mfCount + 1) * sizeof *mfs);
-            strcpy(mfs[mfCount].rep_username, current->username);
-            strcpy(mfs[mfCount].manifesto, buffer);
-            mfCount++;
             printf("\n[SUCCESS] Manifesto submitted.\n");
         }
-
-        save_manifestos(mfs, mfCount);
-        free(mfs);
     }
 }
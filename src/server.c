@@ -0,0 +1,414 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include "server.h"
+#include "fileio.h"
+#include "utils.h"
+#include "metrics.h"
+
+// A ballot waiting for the group commit; owned by the worker that queued it
+typedef struct {
+    Vote vote;
+    int status;  // 0 pending, 1 committed, 2 already voted, -1 storage error
+} VoteRequest;
+
+typedef struct {
+    ElectionState *st;
+    pthread_rwlock_t stateLock;  // read: LOGIN/VOTED/TALLY; write: commit, refresh
+
+    pthread_mutex_t queueMu;     // accepted connections waiting for a worker
+    pthread_cond_t queueCv;
+    int queue[SERVER_QUEUE_LEN];
+    int qHead, qCount;
+
+    pthread_mutex_t commitMu;    // ballots waiting for the committer
+    pthread_cond_t commitCv;     // wakes the committer
+    pthread_cond_t doneCv;       // wakes workers once their batch is committed
+    VoteRequest *pending[SERVER_BATCH_MAX];
+    int pendingCount;
+    bool draining;               // workers are gone: commit what is left and stop
+} Server;
+
+static volatile sig_atomic_t stopping = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+/**
+ * ? Read one request line (without its newline) from a client.
+ *
+ * @return 0 on success; -1 if the client sent nothing.
+ */
+static int read_request(int fd, char *buf, size_t len) {
+    size_t n = 0;
+    while (n + 1 < len) {
+        ssize_t r = read(fd, buf + n, len - 1 - n);
+        if (r <= 0) break;
+        n += r;
+        if (memchr(buf, '\n', n)) break;
+    }
+    buf[n] = '\0';
+    buf[strcspn(buf, "\r\n")] = '\0';
+    return n > 0 ? 0 : -1;
+}
+
+static void reply(int fd, const char *text) {
+    size_t len = strlen(text);
+    while (len > 0) {
+        ssize_t w = write(fd, text, len);
+        if (w <= 0) return;
+        text += w;
+        len -= w;
+    }
+}
+
+//* caller holds commitMu
+static bool is_pending(const Server *srv, const char *student) {
+    for (int i = 0; i < srv->pendingCount; i++)
+        if (strcmp(srv->pending[i]->vote.student_username, student) == 0)
+            return true;
+    return false;
+}
+
+/**
+ * ? Check whether a student has voted, including ballots not yet committed.
+ *
+ * The pending list is checked before the state: the committer adds a
+ * ballot to the state before removing it from the pending list, so a
+ * ballot is always visible in at least one of the two.
+ */
+static bool has_voted(Server *srv, const char *student) {
+    pthread_mutex_lock(&srv->commitMu);
+    bool voted = is_pending(srv, student);
+    pthread_mutex_unlock(&srv->commitMu);
+    if (voted) return true;
+
+    pthread_rwlock_rdlock(&srv->stateLock);
+    voted = state_has_voted(srv->st, student);
+    pthread_rwlock_unlock(&srv->stateLock);
+    return voted;
+}
+
+/**
+ * ? Reload the state if `username` is unknown (registered after startup).
+ */
+static void refresh_if_unknown(Server *srv, const char *username) {
+    pthread_rwlock_rdlock(&srv->stateLock);
+    bool known = user_store_find(&srv->st->users, username) != NULL;
+    pthread_rwlock_unlock(&srv->stateLock);
+    if (known) return;
+    pthread_rwlock_wrlock(&srv->stateLock);
+    state_refresh(srv->st);
+    pthread_rwlock_unlock(&srv->stateLock);
+}
+
+/**
+ * ? Validate a ballot, queue it for the group commit and wait for the result.
+ *
+ * @return Reply line for the client.
+ */
+static const char *handle_vote(Server *srv, const char *student, const char *rep) {
+    VoteRequest req = {0};
+    strncpy(req.vote.student_username, student, USERNAME_LEN - 1);
+    strncpy(req.vote.rep_username, rep, USERNAME_LEN - 1);
+
+    pthread_mutex_lock(&srv->commitMu);
+    while (srv->pendingCount == SERVER_BATCH_MAX)
+        pthread_cond_wait(&srv->doneCv, &srv->commitMu);
+
+    const char *err = NULL;
+    if (is_pending(srv, student)) {
+        err = "ERR already-voted\n";
+    } else {
+        pthread_rwlock_rdlock(&srv->stateLock);
+        const User *u = user_store_find(&srv->st->users, student);
+        if (!u || u->role != ROLE_STUDENT) err = "ERR not-a-student\n";
+        else if (srv->st->mfCount == 0) err = "ERR no-candidates\n";
+        else if (name_index_get(&srv->st->tally.ids, rep) < 0) err = "ERR not-a-candidate\n";
+        else if (state_has_voted(srv->st, student)) err = "ERR already-voted\n";
+        pthread_rwlock_unlock(&srv->stateLock);
+    }
+    if (err) {
+        pthread_mutex_unlock(&srv->commitMu);
+        return err;
+    }
+
+    srv->pending[srv->pendingCount++] = &req;
+    pthread_cond_signal(&srv->commitCv);
+    while (req.status == 0)
+        pthread_cond_wait(&srv->doneCv, &srv->commitMu);
+    pthread_mutex_unlock(&srv->commitMu);
+
+    if (req.status == 1) return "OK\n";
+    if (req.status == 2) return "ERR already-voted\n";
+    return "ERR storage\n";
+}
+
+/**
+ * ? Serve a single request on an accepted connection.
+ */
+static void handle_client(Server *srv, int fd) {
+    char line[128], cmd[16], a[USERNAME_LEN], b[PASS_LEN], out[64];
+    if (read_request(fd, line, sizeof line) != 0) return;
+    int argc = sscanf(line, "%15s %31s %31s", cmd, a, b);
+    if (argc < 1) { reply(fd, "ERR syntax\n"); return; }
+
+    if (strcmp(cmd, "PING") == 0) {
+        reply(fd, "PONG\n");
+    } else if (strcmp(cmd, "LOGIN") == 0 && argc == 3) {
+        refresh_if_unknown(srv, a);
+        pthread_rwlock_rdlock(&srv->stateLock);
+        User u;
+        int ok = authenticate(&srv->st->users, a, b, &u);  // default-admin rule included
+        pthread_rwlock_unlock(&srv->stateLock);
+        if (ok) {
+            snprintf(out, sizeof out, "OK %d\n", (int)u.role);
+            reply(fd, out);
+        } else {
+            reply(fd, "ERR credentials\n");
+        }
+    } else if (strcmp(cmd, "VOTED") == 0 && argc == 2) {
+        reply(fd, has_voted(srv, a) ? "YES\n" : "NO\n");
+    } else if (strcmp(cmd, "VOTE") == 0 && argc == 3) {
+        refresh_if_unknown(srv, a);
+        refresh_if_unknown(srv, b);  // a rep registered after startup
+        reply(fd, handle_vote(srv, a, b));
+    } else if (strcmp(cmd, "TALLY") == 0) {
+        //* format under the read lock, write after it: a slow reader must
+        //* not hold back the committer
+        pthread_rwlock_rdlock(&srv->stateLock);
+        const Tally *t = &srv->st->tally;
+        size_t rowMax = USERNAME_LEN + 16, used = 0;
+        char *rows = malloc(t->count * rowMax + 1);
+        for (int i = 0; rows && i < t->count; i++)
+            used += snprintf(rows + used, rowMax, "%s %d\n", t->names[i], t->counts[i]);
+        pthread_rwlock_unlock(&srv->stateLock);
+        if (!rows) {
+            reply(fd, "ERR storage\n");
+            return;
+        }
+        rows[used] = '\0';
+        reply(fd, rows);
+        free(rows);
+        reply(fd, "END\n");
+    } else {
+        reply(fd, "ERR syntax\n");
+    }
+}
+
+static void *worker_main(void *arg) {
+    Server *srv = arg;
+    for (;;) {
+        pthread_mutex_lock(&srv->queueMu);
+        while (srv->qCount == 0 && !stopping)
+            pthread_cond_wait(&srv->queueCv, &srv->queueMu);
+        if (srv->qCount == 0) {
+            pthread_mutex_unlock(&srv->queueMu);
+            break;
+        }
+        int fd = srv->queue[srv->qHead];
+        srv->qHead = (srv->qHead + 1) % SERVER_QUEUE_LEN;
+        srv->qCount--;
+        pthread_cond_broadcast(&srv->queueCv);  // room for the acceptor
+        pthread_mutex_unlock(&srv->queueMu);
+
+        handle_client(srv, fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * ? Group-commit loop.
+ *
+ * Takes every queued ballot, re-checks it under the data-directory lock
+ * against votes cast by other instances, appends the survivors with one
+ * fsync, adds them to the state and wakes their workers. When idle it
+ * refreshes the state once a second, without the data-directory lock, so
+ * outside changes are picked up.
+ */
+static void *committer_main(void *arg) {
+    Server *srv = arg;
+    Vote batch[SERVER_BATCH_MAX], accepted[SERVER_BATCH_MAX];
+    int status[SERVER_BATCH_MAX];
+
+    for (;;) {
+        pthread_mutex_lock(&srv->commitMu);
+        if (srv->pendingCount == 0 && !srv->draining) {
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_sec += 1;
+            pthread_cond_timedwait(&srv->commitCv, &srv->commitMu, &until);
+        }
+        int n = srv->pendingCount;
+        for (int i = 0; i < n; i++) batch[i] = srv->pending[i]->vote;
+        bool done = n == 0 && srv->draining;
+        pthread_mutex_unlock(&srv->commitMu);
+        if (done) break;
+        if (n == 0) {
+            pthread_rwlock_wrlock(&srv->stateLock);
+            state_refresh(srv->st);
+            pthread_rwlock_unlock(&srv->stateLock);
+            metrics_maybe_flush();
+            continue;
+        }
+
+        int lock = storage_lock();
+        pthread_rwlock_wrlock(&srv->stateLock);
+        state_refresh(srv->st);
+        int kept = 0;
+        for (int i = 0; i < n; i++) {
+            if (state_has_voted(srv->st, batch[i].student_username)) {
+                status[i] = 2;  // cast from another terminal meanwhile
+            } else {
+                status[i] = 1;
+                accepted[kept++] = batch[i];
+            }
+        }
+        if (kept > 0) {
+            if (lock >= 0 && append_votes(accepted, kept) == 0) {
+                state_absorb_votes(srv->st, accepted, kept);
+            } else {
+                for (int i = 0; i < n; i++)
+                    if (status[i] == 1) status[i] = -1;
+            }
+        }
+        pthread_rwlock_unlock(&srv->stateLock);
+        storage_unlock(lock);
+        metrics_maybe_flush();
+
+        pthread_mutex_lock(&srv->commitMu);
+        for (int i = 0; i < n; i++) srv->pending[i]->status = status[i];
+        srv->pendingCount -= n;
+        memmove(srv->pending, srv->pending + n, srv->pendingCount * sizeof *srv->pending);
+        pthread_cond_broadcast(&srv->doneCv);
+        pthread_mutex_unlock(&srv->commitMu);
+    }
+    return NULL;
+}
+
+/**
+ * ? Run the vote daemon until SIGINT/SIGTERM.
+ *
+ * The calling thread accepts connections on a Unix domain socket and hands
+ * them to `nthreads` workers. Each connection carries one request (see
+ * server.h). Read requests share a read lock on the state and run in
+ * parallel; ballots are funnelled to a single committer that batches them
+ * into one journal append and one fsync.
+ *
+ * @param st         Loaded election state; owned by the daemon while it runs.
+ * @param sock_path  Socket file to create in the data directory.
+ * @param nthreads   Number of worker threads (at least 1).
+ * @return           0 on clean shutdown; -1 if the socket cannot be set up.
+ *
+ * * Usage:
+ *   - `election serve [threads]` on the polling-station host; terminals
+ *     started afterwards in the same directory detect it and use it.
+ */
+int server_run(ElectionState *st, const char *sock_path, int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0) { perror("socket"); return -1; }
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, sock_path, sizeof addr.sun_path - 1);
+    unlink(sock_path);
+    if (bind(lfd, (struct sockaddr *)&addr, sizeof addr) != 0 || listen(lfd, 128) != 0) {
+        perror("bind/listen");
+        close(lfd);
+        return -1;
+    }
+
+    Server srv = {0};
+    srv.st = st;
+    pthread_rwlock_init(&srv.stateLock, NULL);
+    pthread_mutex_init(&srv.queueMu, NULL);
+    pthread_cond_init(&srv.queueCv, NULL);
+    pthread_mutex_init(&srv.commitMu, NULL);
+    pthread_cond_init(&srv.commitCv, NULL);
+    pthread_cond_init(&srv.doneCv, NULL);
+
+    //* only this thread takes SIGINT/SIGTERM, so accept() is interrupted
+    struct sigaction sa = {0};
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+
+    pthread_t committer;
+    pthread_t *workers = malloc(nthreads * sizeof *workers);
+    pthread_create(&committer, NULL, committer_main, &srv);
+    for (int i = 0; i < nthreads; i++)
+        pthread_create(&workers[i], NULL, worker_main, &srv);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    printf("[SERVER] Listening on %s with %d worker(s). Press Ctrl+C to stop.\n",
+           sock_path, nthreads);
+    fflush(stdout);
+
+    while (!stopping) {
+        int fd = accept(lfd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        struct timeval timeout = {SERVER_IO_TIMEOUT_SECONDS, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+        pthread_mutex_lock(&srv.queueMu);
+        while (srv.qCount == SERVER_QUEUE_LEN && !stopping)
+            pthread_cond_wait(&srv.queueCv, &srv.queueMu);
+        if (srv.qCount == SERVER_QUEUE_LEN) {
+            pthread_mutex_unlock(&srv.queueMu);
+            close(fd);
+            break;
+        }
+        srv.queue[(srv.qHead + srv.qCount) % SERVER_QUEUE_LEN] = fd;
+        srv.qCount++;
+        pthread_cond_broadcast(&srv.queueCv);
+        pthread_mutex_unlock(&srv.queueMu);
+    }
+
+    //* workers finish queued requests, then the committer drains its batch
+    stopping = 1;
+    pthread_mutex_lock(&srv.queueMu);
+    pthread_cond_broadcast(&srv.queueCv);
+    pthread_mutex_unlock(&srv.queueMu);
+    for (int i = 0; i < nthreads; i++)
+        pthread_join(workers[i], NULL);
+    pthread_mutex_lock(&srv.commitMu);
+    srv.draining = true;
+    pthread_cond_signal(&srv.commitCv);
+    pthread_mutex_unlock(&srv.commitMu);
+    pthread_join(committer, NULL);
+
+    free(workers);
+    close(lfd);
+    unlink(sock_path);
+    pthread_rwlock_destroy(&srv.stateLock);
+    pthread_mutex_destroy(&srv.queueMu);
+    pthread_cond_destroy(&srv.queueCv);
+    pthread_mutex_destroy(&srv.commitMu);
+    pthread_cond_destroy(&srv.commitCv);
+    pthread_cond_destroy(&srv.doneCv);
+    printf("[SERVER] Stopped.\n");
+    return 0;
+}
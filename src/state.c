@@ -0,0 +1,425 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "state.h"
+#include "fileio.h"
+
+/**
+ * ? Record the current size, mtime and inode of a file.
+ *
+ * A missing file gets an all-zero stamp.
+ */
+static void stamp_file(const char *path, FileStamp *s) {
+    struct stat st;
+    memset(s, 0, sizeof *s);
+    if (stat(path, &st) != 0) return;
+    s->size = st.st_size;
+    s->mtime_ns = (long long)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    s->ino = st.st_ino;
+}
+
+/**
+ * ? Check whether a file changed since it was stamped.
+ *
+ * Only stat() is called; the file itself is not read.
+ */
+static bool stamp_changed(const char *path, const FileStamp *s) {
+    FileStamp now;
+    stamp_file(path, &now);
+    return now.size != s->size || now.mtime_ns != s->mtime_ns || now.ino != s->ino;
+}
+
+/**
+ * ? Rebuild the live tally from the in-memory reps and votes.
+ *
+ * Starts from the counts saved in tallies.txt when they still match the
+ * vote log, so only the votes cast since the last save are counted.
+ *
+ * @param st         State whose reps and votes are loaded.
+ * @param use_saved  Whether tallies.txt may be used (false: full recount).
+ */
+static int recount(ElectionState *st, bool use_saved) {
+    tally_free(&st->tally);
+    if (tally_init(&st->tally, st->repCount) != 0) return -1;
+    for (int i = 0; i < st->repCount; i++)
+        if (tally_add_candidate(&st->tally, st->reps[i].username) < 0) return -1;
+
+    int covered = use_saved ? load_tallies(&st->tally, &st->log) : -1;
+    if (covered < 0) {
+        memset(st->tally.counts, 0, st->tally.count * sizeof *st->tally.counts);
+        covered = 0;
+    }
+    tally_count_log(&st->tally, &st->log, covered, st->log.count, 0);
+    return 0;
+}
+
+/**
+ * ? Extract the representatives from the user store.
+ *
+ * Only the entry the store resolves a username to counts, so a duplicated
+ * line neither adds a second candidate nor turns a student into a rep.
+ */
+static int rebuild_reps(ElectionState *st) {
+    free(st->reps);
+    st->reps = malloc((st->users.count ? st->users.count : 1) * sizeof *st->reps);
+    st->repCount = 0;
+    if (!st->reps) return -1;
+    for (int i = 0; i < st->users.count; i++) {
+        const User *u = &st->users.users[i];
+        if (u->role == ROLE_REP && user_store_find(&st->users, u->username) == u)
+            st->reps[st->repCount++] = *u;
+    }
+    return 0;
+}
+
+static int reload_users(ElectionState *st) {
+    stamp_file(Users_Path, &st->usersStamp);
+    user_store_free(&st->users);
+    if (user_store_load(&st->users) < 0) return -1;
+    return rebuild_reps(st);
+}
+
+static void reload_manifestos(ElectionState *st) {
+    stamp_file(Manifesto_Path, &st->mfsStamp);
+    free(st->mfs);
+    st->mfCount = load_manifestos(&st->mfs);
+    st->dirty &= ~DIRTY_MANIFESTOS;
+}
+
+/**
+ * ? Reload the vote log.
+ *
+ * The records are parsed into a temporary Vote array and interned into
+ * the id columns, which is all the state keeps.
+ *
+ * @return Number of votes that were already in memory and are still a
+ *         prefix of the reloaded log (new votes were only appended), or -1
+ *         if the log was rewritten and the tally must be rebuilt.
+ */
+static int reload_votes(ElectionState *st) {
+    bool appendOnly = !stamp_changed(Votes_Path, &st->votesStamp);
+    int before = st->log.count;
+    stamp_file(Votes_Path, &st->votesStamp);
+    stamp_file(Votes_Journal_Path, &st->journalStamp);
+    Vote *votes = NULL;
+    int n = load_votes(&votes);
+    vote_log_free(&st->log);
+    if (vote_log_init(&st->log, n) != 0 || vote_log_append(&st->log, votes, n) != 0)
+        fprintf(stderr, "[ERROR] Out of memory while loading votes.\n");
+    free(votes);
+    //* the stamp only tells where the log ends if nothing was appended meanwhile
+    st->journalOffset = stamp_changed(Votes_Journal_Path, &st->journalStamp) ? -1 : st->journalStamp.size;
+    return appendOnly && st->log.count >= before ? before : -1;
+}
+
+/**
+ * ? Absorb the ballots appended to the vote journal since the last read.
+ *
+ * Reads only the bytes past `journalOffset`, so a refresh costs as much as
+ * the new ballots, not the whole log.
+ *
+ * @return false if the journal was replaced or truncated (or the offset is
+ *         unknown) and the caller must reload the whole log.
+ */
+static bool absorb_journal_tail(ElectionState *st) {
+    FileStamp now;
+    stamp_file(Votes_Journal_Path, &now);
+    if (st->journalOffset < 0 || now.ino != st->journalStamp.ino || now.size < st->journalOffset)
+        return false;
+    long long offset = st->journalOffset;
+    Vote *votes = NULL;
+    int n = load_journal_tail(&offset, &votes);
+    bool ok = n >= 0 && vote_log_append(&st->log, votes, n) == 0;
+    free(votes);
+    if (!ok) return false;
+    st->journalStamp = now;  // stamped before reading: later appends show up as a change
+    st->journalOffset = offset;
+    return true;
+}
+
+static void reload_results(ElectionState *st) {
+    stamp_file(Results_Path, &st->resultsStamp);
+    free(st->resMfs);
+    free(st->resCounts);
+    st->resCount = load_results(&st->resMfs, &st->resCounts, &st->resEpoch);
+}
+
+static void reload_published(ElectionState *st) {
+    stamp_file(Vote_Updates_Path, &st->publishedStamp);
+    st->publishedEpoch = load_published_epoch();
+}
+
+/**
+ * ? Load the whole election into memory.
+ *
+ * Files are stamped before being read, so a write that races with the
+ * load is picked up by the next state_refresh().
+ *
+ * @param st  Zero-initialized state.
+ * @return    0 on success; -1 on memory allocation failure.
+ *
+ * * Usage:
+ *   - Called once from main() after the startup checks.
+ */
+int state_load(ElectionState *st) {
+    if (reload_users(st) != 0) return -1;
+    reload_manifestos(st);
+    reload_votes(st);
+    reload_results(st);
+    reload_published(st);
+    return recount(st, true);
+}
+
+/**
+ * ? Reload the parts of the state whose files changed on disk.
+ *
+ * Costs one stat() per file when nothing changed; in that case menus
+ * keep working from memory with no file reads at all. Votes appended to
+ * the journal by another instance are read from the journal's tail and
+ * folded into the live tally incrementally; any other change reloads the
+ * log and rebuilds it.
+ *
+ * * Usage:
+ *   - Called at the top of every menu iteration.
+ */
+void state_refresh(ElectionState *st) {
+    bool users = stamp_changed(Users_Path, &st->usersStamp);
+    bool snapshot = stamp_changed(Votes_Path, &st->votesStamp);
+    bool journal = stamp_changed(Votes_Journal_Path, &st->journalStamp);
+
+    if (users) reload_users(st);
+    if (stamp_changed(Manifesto_Path, &st->mfsStamp)) reload_manifestos(st);
+    int prefix = st->log.count;
+    if (snapshot || (journal && !absorb_journal_tail(st))) prefix = reload_votes(st);
+    if (stamp_changed(Results_Path, &st->resultsStamp)) reload_results(st);
+    if (stamp_changed(Vote_Updates_Path, &st->publishedStamp)) reload_published(st);
+
+    //* ballots appended by another instance: count just those
+    if (users || prefix < 0)
+        recount(st, false);
+    else
+        tally_count_log(&st->tally, &st->log, prefix, st->log.count, 0);
+}
+
+/**
+ * ? Register a new user (write-through to users.txt).
+ *
+ * Under the storage lock: picks up accounts and rewrites from other
+ * instances, re-checks the username (the caller's check may be stale by
+ * the time the user finished typing), then appends. A concurrent
+ * save_users() cannot rename users.txt between the refresh and the append.
+ * A new rep gets a manifesto placeholder under the same lock, synced from
+ * the in-memory reps.
+ *
+ * @return 0 on success; 1 if the username is already taken;
+ *         -1 on I/O or memory errors.
+ */
+int state_add_user(ElectionState *st, const User *u) {
+    int lock = storage_lock();
+    if (lock < 0) return -1;
+    state_refresh(st);
+
+    int result = 1;
+    if (!user_store_find(&st->users, u->username)) {
+        result = user_store_add(&st->users, u) == 0 ? 0 : -1;
+        stamp_file(Users_Path, &st->usersStamp);
+    }
+    if (result == 0 && u->role == ROLE_REP) {
+        User *grown = realloc(st->reps, (st->repCount + 1) * sizeof *grown);
+        if (!grown) result = -1;
+        else {
+            st->reps = grown;
+            st->reps[st->repCount++] = *u;
+            if (tally_add_candidate(&st->tally, u->username) < 0) result = -1;
+        }
+    }
+    if (result == 0 && u->role == ROLE_REP) {
+        sync_manifestos_with_users(st->reps, st->repCount);
+        if (stamp_changed(Manifesto_Path, &st->mfsStamp)) reload_manifestos(st);
+    }
+    storage_unlock(lock);
+    return result;
+}
+
+/**
+ * ? Check whether a student already has a ballot in the state.
+ *
+ * Constant-time lookup in the log's student table, whatever the turnout.
+ */
+bool state_has_voted(const ElectionState *st, const char *student) {
+    return vote_log_has_voted(&st->log, student);
+}
+
+/**
+ * ? Add ballots that are already durable in the journal to memory.
+ *
+ * Updates the vote log (and with it the voted set) and the live tally,
+ * then re-stamps the journal.
+ *
+ * @return 0 on success; -1 on memory allocation failure.
+ */
+int state_absorb_votes(ElectionState *st, const Vote *votes, int count) {
+    int first = st->log.count;
+    int result = vote_log_append(&st->log, votes, count);
+    tally_count_log(&st->tally, &st->log, first, st->log.count, 0);
+    //* under the lock after a refresh: the journal holds nothing else
+    stamp_file(Votes_Journal_Path, &st->journalStamp);
+    st->journalOffset = st->journalStamp.size;
+    return result;
+}
+
+/**
+ * ? Record a ballot (write-through to the vote journal).
+ *
+ * Runs under the data-directory lock: the state is refreshed first so
+ * ballots cast from other terminals are seen, the student is re-checked,
+ * and only then is the vote appended. Memory and the live tally are
+ * updated once the vote is on disk.
+ *
+ * @return 0 on success; 1 if the student has already voted; 2 if the
+ *         rep is not a candidate; -1 on I/O or memory errors.
+ */
+int state_add_vote(ElectionState *st, const Vote *v) {
+    int lock = storage_lock();
+    if (lock < 0) return -1;
+    state_refresh(st);
+
+    int result = 1;
+    if (name_index_get(&st->tally.ids, v->rep_username) < 0) {
+        result = 2;
+    } else if (!state_has_voted(st, v->student_username)) {
+        result = append_vote(v) == 0 ? state_absorb_votes(st, v, 1) : -1;
+    }
+    storage_unlock(lock);
+    return result;
+}
+
+/**
+ * ? Create or replace a representative's manifesto, then commit it.
+ *
+ * Under the storage lock and after a refresh, so the rewrite of
+ * manifestos.txt keeps edits and rep placeholders from other terminals.
+ *
+ * @return 0 on success; -1 on I/O or memory errors.
+ */
+int state_set_manifesto(ElectionState *st, const char *rep, const char *text) {
+    int lock = storage_lock();
+    if (lock < 0) return -1;
+    state_refresh(st);
+
+    int idx = -1;
+    for (int i = 0; i < st->mfCount; i++) {
+        if (strcmp(st->mfs[i].rep_username, rep) == 0) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0) {
+        Manifesto *grown = realloc(st->mfs, (st->mfCount + 1) * sizeof *grown);
+        if (!grown) {
+            storage_unlock(lock);
+            return -1;
+        }
+        st->mfs = grown;
+        idx = st->mfCount++;
+        memset(&st->mfs[idx], 0, sizeof st->mfs[idx]);
+        strncpy(st->mfs[idx].rep_username, rep, USERNAME_LEN - 1);
+    }
+    strncpy(st->mfs[idx].manifesto, text, MANIFESTO_LEN - 1);
+    st->mfs[idx].manifesto[MANIFESTO_LEN - 1] = '\0';
+    st->dirty |= DIRTY_MANIFESTOS;
+    int result = state_commit(st);
+    storage_unlock(lock);
+    return result;
+}
+
+/**
+ * ? Persist every dirty section and re-stamp the files written.
+ *
+ * @return 0 on success; -1 if a save failed (the section stays dirty).
+ */
+int state_commit(ElectionState *st) {
+    if (st->dirty & DIRTY_MANIFESTOS) {
+        if (save_manifestos(st->mfs, st->mfCount) != 0) return -1;
+        stamp_file(Manifesto_Path, &st->mfsStamp);
+        st->dirty &= ~DIRTY_MANIFESTOS;
+    }
+    return 0;
+}
+
+/**
+ * ? Save the live tally, folding the vote journal into votes.txt first
+ *   once it has grown past `VOTE_JOURNAL_COMPACT_BYTES`.
+ *
+ * Compaction rewrites the whole vote log, so it is amortised over many
+ * publishes instead of paid on each one; a checkpoint with a small journal
+ * costs O(candidates).
+ *
+ * @return 0 on success; -1 if compaction or the tally save failed.
+ *
+ * * Usage:
+ *   - Called after results are published.
+ */
+int state_checkpoint(ElectionState *st) {
+    int lock = storage_lock();
+    if (lock < 0) return -1;
+    state_refresh(st);  // don't let the re-stamp below hide outside changes
+    int result = 0;
+    if (st->journalStamp.size > VOTE_JOURNAL_COMPACT_BYTES) {
+        result = compact_votes();
+        stamp_file(Votes_Path, &st->votesStamp);
+        stamp_file(Votes_Journal_Path, &st->journalStamp);
+        st->journalOffset = result == 0 ? st->journalStamp.size : -1;
+    }
+    if (save_tallies(&st->tally, &st->log) != 0) result = -1;
+    storage_unlock(lock);
+    return result;
+}
+
+/**
+ * ? Record that the published results cover the first `epoch` votes.
+ *
+ * The vote log only grows, so its length is the vote epoch: results are
+ * current while `publishedEpoch == log.count`, and the ballots cast since
+ * the publish are votes [publishedEpoch, log.count) of the log.
+ *
+ * @param st     Current election state.
+ * @param epoch  Vote count the results were computed from.
+ * @return       0 on success; -1 on write failure.
+ */
+int state_mark_published(ElectionState *st, int epoch) {
+    if (mark_results_published(epoch) != 0) return -1;
+    st->publishedEpoch = epoch;
+    stamp_file(Vote_Updates_Path, &st->publishedStamp);
+    return 0;
+}
+
+/**
+ * ? Compare the live tally with a full recount of the vote log.
+ *
+ * On mismatch the live tally is replaced by the recount.
+ *
+ * @return Number of candidates whose running count was wrong; -1 on
+ *         memory allocation failure.
+ */
+int state_verify_tally(ElectionState *st) {
+    int mismatches = tally_verify(&st->tally, &st->log);
+    if (mismatches > 0) recount(st, false);
+    return mismatches;
+}
+
+/**
+ * ? Release everything held by the state.
+ */
+void state_free(ElectionState *st) {
+    user_store_free(&st->users);
+    tally_free(&st->tally);
+    free(st->reps);
+    free(st->mfs);
+    vote_log_free(&st->log);
+    free(st->resMfs);
+    free(st->resCounts);
+    memset(st, 0, sizeof *st);
+}
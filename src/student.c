@@ -5,6 +5,9 @@
 #include "student.h"
 #include "fileio.h"
 #include "utils.h"
+#include "tally.h"
+#include "client.h"
+#include "metrics.h"
 
 void students_actions() {
     printf("\nAs a student, you can:\n");
@@ -21,41 +24,59 @@ void Display_manifestos(const Manifesto *mfs, int mfCount) {
         printf("• %s:\n%s\n\n", mfs[i].rep_username, mfs[i].manifesto);
     }
 }
-int check_already_voted(const Vote *votes, int voteCount, const char *username) {
-    for (int i = 0; i < voteCount; i++) {
-        if (strcmp(votes[i].student_username, username) == 0) {
-            printf("\n[ERROR] You've already voted!\n");
-            return 1; // Already voted
-        }
+int check_already_voted(const ElectionState *st, const char *username) {
+    //* the vote daemon also knows about ballots still waiting to be committed
+    int voted = client_active() ? client_has_voted(username) : -1;
+    if (voted < 0) voted = state_has_voted(st, username);
+    if (voted) {
+        printf("\n[ERROR] You've already voted!\n");
+        return 1; // Already voted
     }
     printf("\n[SUCCESS] You have not voted yet.\n");
     return 0; // Not voted yet
 }
-int validate_candidate(const User *current, const Manifesto *mfs, int mfCount) {
+int validate_candidate(const ElectionState *st, const User *current, const char *choice) {
     if (current->role != ROLE_STUDENT) {
         printf("[WARNING] Only students can vote!\n");
         return 0; // Not a student
     }
-    if (mfCount == 0) {
+    if (st->mfCount == 0) {
         printf("[WARNING] No candidates available to vote for.\n");
         return 0; // No candidates
     }
+    if (choice[0] == '\0' || name_index_get(&st->tally.ids, choice) < 0) {
+        printf("[ERROR] '%s' is not a candidate.\n", choice);
+        return 0; // Empty or unknown choice
+    }
     return 1; // Valid candidate
 }
 
-void record_new_vote(const User *current, const char *choice) {
+void record_new_vote(ElectionState *st, const User *current, const char *choice) {
+    METRIC_START(t);
     Vote newVote;
     strcpy(newVote.student_username, current->username);
     strcpy(newVote.rep_username, choice);
 
-    Vote *votes = NULL;
-    int voteCount = load_votes(&votes);
-    votes = realloc(votes, (voteCount + 1) * sizeof *votes);
-    votes[voteCount++] = newVote;
-    save_votes(votes, voteCount);
-    free(votes);
-    //! Append vote update to results file
-    append_vote_update(current);
+    //! Through the vote daemon when one runs, else a locked journal append
+    int result;
+    if (client_active()) {
+        result = client_vote(newVote.student_username, newVote.rep_username);
+    } else {
+        result = state_add_vote(st, &newVote);
+    }
+    METRIC_STOP(MET_RECORD_VOTE, t);
+    if (result == 1) {
+        printf("\n[ERROR] You've already voted!\n");
+        return;
+    }
+    if (result == 2) {
+        printf("[ERROR] '%s' is not a candidate.\n", choice);
+        return;
+    }
+    if (result != 0) {
+        printf("[ERROR] Could not record your vote. Please try again.\n");
+        return;
+    }
     printf("[SUCCESS] Vote cast for %s!\n", choice);
 }
 /* 
@@ -69,7 +90,7 @@ void results_summary(const Manifesto *resMfs, const int *counts, int resCount) {
 } */
 
 
-void student_menu(const User *current) {
+void student_menu(ElectionState *st, const User *current) {
     printf("\n=======================================");
     printf("\n      [Welcome] Student: %s\n", current->username);
     printf("=======================================\n");
@@ -84,29 +105,22 @@ void student_menu(const User *current) {
             logging_out();
             break;
         }
-
-        Manifesto *mfs = NULL;
-        int mfCount = load_manifestos(&mfs);
+        state_refresh(st);
 
         if (opt == 1) {
             // Display manifestos
-            Display_manifestos(mfs, mfCount);
-            if (mfCount == 0) {
+            Display_manifestos(st->mfs, st->mfCount);
+            if (st->mfCount == 0) {
                 printf("[WARNING] No manifestos available. Please check back later.\n");
                 continue;
             }
             printf("[SUCCESS] Manifestos loaded successfully.\n");
         } 
         else if (opt == 2) {
-            Vote *votes = NULL;
-            int voteCount = load_votes(&votes);
-            
             //! Check if already voted
-            if (check_already_voted(votes, voteCount, current->username)) {
-                free(votes);
-                goto student_continue;
+            if (check_already_voted(st, current->username)) {
+                continue;
             }
-            free(votes);
 
             //! Get vote choice
             char choice[USERNAME_LEN];
@@ -115,57 +129,36 @@ void student_menu(const User *current) {
             choice[strcspn(choice, "\r\n")] = '\0'; // Remove trailing newline
 
             //! Validate candidate
-            if (!validate_candidate(current, mfs, mfCount)) {
-                free(mfs);
+            if (!validate_candidate(st, current, choice)) {
                 continue; // Invalid candidate, prompt again
             }
 
             //! Record vote
-            record_new_vote(current, choice);
+            record_new_vote(st, current, choice);
         } 
         else if (opt == 3) {
-            Manifesto *resMfs = NULL;
-            int *counts = NULL;
-            int resCount = load_results(&resMfs, &counts);
-            Vote *votes = NULL;
-            int voteCount = load_votes(&votes);
-
-
             //! Compute longest username width
             //? This is to ensure proper alignment in the output
             int maxNameLen = 0;
-            for (int i = 0; i < resCount; i++) {
-                int len = strlen(resMfs[i].rep_username);
+            for (int i = 0; i < st->resCount; i++) {
+                int len = strlen(st->resMfs[i].rep_username);
                 if (len > maxNameLen) maxNameLen = len;
             }
 
-            // Display each rep and their vote count
+            // Display each rep and their vote count from the live tally
             printf("=================================================\n\n");
-            display_result_status();
+            display_result_status(st->log.count, st->publishedEpoch);
             printf("\nElection Results:\n");
-            for (int i = 0; i < resCount; i++) {
-                int cnt = 0;
-                for (int j = 0; j < voteCount; j++) {
-                    if (strcmp(votes[j].rep_username, resMfs[i].rep_username) == 0) {
-                        cnt++;
-                    }
-                }
+            for (int i = 0; i < st->resCount; i++) {
                 printf(" • %-*s : %4d votes\n",
                     maxNameLen,
-                    resMfs[i].rep_username,
-                    cnt);
+                    st->resMfs[i].rep_username,
+                    tally_votes_for(&st->tally, st->resMfs[i].rep_username));
             }
-
-            free(resMfs);
-            free(counts);
-
         }
         else {
             printf("[ERROR] Invalid option! Please try again.\n");
-            free(mfs);
             continue; // Invalid option, prompt again
         }
-        student_continue:
-        free(mfs);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,274 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "tally.h"
+
+#define TALLY_CACHE_LINE 64
+
+/**
+ * ? Prepare an empty tally.
+ *
+ * @param t         Tally to initialize.
+ * @param expected  Expected number of candidates (sizing hint).
+ * @return          0 on success; -1 on memory allocation failure.
+ */
+int tally_init(Tally *t, int expected) {
+    t->names = NULL;
+    t->counts = NULL;
+    t->count = t->cap = 0;
+    return name_index_init(&t->ids, expected);
+}
+
+/**
+ * ? Register a candidate and give it a dense integer id.
+ *
+ * Adding the same username twice returns the id it already has.
+ *
+ * @param t             Tally to update.
+ * @param rep_username  Candidate's username.
+ * @return              Candidate id (0..count-1); -1 on memory allocation failure.
+ */
+int tally_add_candidate(Tally *t, const char *rep_username) {
+    int id = name_index_get(&t->ids, rep_username);
+    if (id >= 0) return id;
+
+    if (t->count == t->cap) {
+        int cap = t->cap ? t->cap * 2 : 8;
+        char (*names)[USERNAME_LEN] = realloc(t->names, cap * sizeof *names);
+        if (!names) return -1;
+        t->names = names;
+        int *counts = realloc(t->counts, cap * sizeof *counts);
+        if (!counts) return -1;
+        t->counts = counts;
+        t->cap = cap;
+    }
+    id = t->count;
+    if (name_index_put(&t->ids, rep_username, id) != 0) return -1;
+    strncpy(t->names[id], rep_username, USERNAME_LEN - 1);
+    t->names[id][USERNAME_LEN - 1] = '\0';
+    t->counts[id] = 0;
+    t->count++;
+    return id;
+}
+
+/**
+ * ? Count votes in a single pass.
+ *
+ * Each vote costs one hash lookup of its rep_username and one increment,
+ * so the whole tally is O(votes + candidates). Votes for usernames that
+ * are not registered candidates are ignored.
+ *
+ * @param t          Tally with all candidates already added.
+ * @param votes      Votes to count.
+ * @param voteCount  Number of votes.
+ */
+void tally_count_votes(Tally *t, const Vote *votes, int voteCount) {
+    for (int i = 0; i < voteCount; i++) {
+        int id = name_index_get(&t->ids, votes[i].rep_username);
+        if (id >= 0) t->counts[id]++;
+    }
+}
+
+// One worker's share of a count: a range of Vote records or of log rep ids
+typedef struct {
+    const Tally *t;
+    const Vote *votes;   // Vote records, or NULL for the two id fields below
+    const uint32_t *rep; // rep id per vote (VoteLog column)
+    const int *cand;     // rep id -> candidate id, -1 if not a candidate
+    int first, last;     // vote range [first, last)
+    int *counts;         // counters to add to (private, on their own cache lines)
+    bool running;        // counted on its own thread, to be joined
+} TallySlice;
+
+static void *count_slice(void *arg) {
+    TallySlice *s = arg;
+    if (s->votes) {
+        for (int i = s->first; i < s->last; i++) {
+            int id = name_index_get(&s->t->ids, s->votes[i].rep_username);
+            if (id >= 0) s->counts[id]++;
+        }
+    } else {
+        //* no hashing or string compares: one table load per vote
+        for (int i = s->first; i < s->last; i++) {
+            int id = s->cand[s->rep[i]];
+            if (id >= 0) s->counts[id]++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * ? Run a count job on several threads and add the result to `t->counts`.
+ *
+ * The range [job.first, job.last) is split into `nthreads` contiguous
+ * slices. Each worker counts into a private counter array whose stride is
+ * rounded up to whole cache lines, so no two threads ever write the same
+ * line; the candidate index is only read. The private arrays are then
+ * summed into `t->counts`. Small inputs, one thread, or a failed
+ * allocation run the job on the calling thread instead.
+ *
+ * @param t         Tally with all candidates already added.
+ * @param job       What to count (`counts` and `running` are filled here).
+ * @param nthreads  Worker threads; 0 uses `TALLY_THREADS`, whose 0 means
+ *                  one per online core.
+ */
+static void run_count(Tally *t, TallySlice job, int nthreads) {
+    int n = job.last - job.first;
+    if (nthreads <= 0) nthreads = TALLY_THREADS;
+    if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    //* keep at least TALLY_PARALLEL_MIN / 4 votes per thread
+    if (nthreads > n / (TALLY_PARALLEL_MIN / 4)) nthreads = n / (TALLY_PARALLEL_MIN / 4);
+
+    size_t perLine = TALLY_CACHE_LINE / sizeof(int);
+    size_t stride = (t->count + perLine - 1) / perLine * perLine;
+    int *counts = NULL;
+    TallySlice *slices = NULL;
+    pthread_t *threads = NULL;
+    if (nthreads > 1 && n >= TALLY_PARALLEL_MIN && t->count > 0) {
+        counts = aligned_alloc(TALLY_CACHE_LINE, nthreads * stride * sizeof *counts);
+        slices = calloc(nthreads, sizeof *slices);
+        threads = calloc(nthreads, sizeof *threads);
+    }
+    if (!counts || !slices || !threads) {
+        free(counts); free(slices); free(threads);
+        job.t = t;
+        job.counts = t->counts;
+        count_slice(&job);
+        return;
+    }
+    memset(counts, 0, nthreads * stride * sizeof *counts);
+
+    int per = (n + nthreads - 1) / nthreads;
+    for (int w = 0; w < nthreads; w++) {
+        slices[w] = job;
+        slices[w].t = t;
+        slices[w].first = job.first + (w * per < n ? w * per : n);
+        slices[w].last = job.first + ((w + 1) * per < n ? (w + 1) * per : n);
+        slices[w].counts = counts + w * stride;
+        slices[w].running = false;
+        //* slice 0 runs on the calling thread
+        if (w > 0)
+            slices[w].running = pthread_create(&threads[w], NULL, count_slice, &slices[w]) == 0;
+    }
+    for (int w = 0; w < nthreads; w++)
+        if (!slices[w].running) count_slice(&slices[w]);  // also covers a failed create
+    for (int w = 1; w < nthreads; w++)
+        if (slices[w].running) pthread_join(threads[w], NULL);
+
+    //* reduction: thread order does not matter, integer sums are exact
+    for (int w = 0; w < nthreads; w++)
+        for (int id = 0; id < t->count; id++)
+            t->counts[id] += slices[w].counts[id];
+
+    free(counts);
+    free(slices);
+    free(threads);
+}
+
+/**
+ * ? Count votes on several threads, with the same result as tally_count_votes().
+ *
+ * @param t          Tally with all candidates already added.
+ * @param votes      Votes to count.
+ * @param voteCount  Number of votes.
+ * @param nthreads   Worker threads (0: `TALLY_THREADS`); see run_count().
+ */
+void tally_count_votes_parallel(Tally *t, const Vote *votes, int voteCount, int nthreads) {
+    TallySlice job = { .votes = votes, .first = 0, .last = voteCount };
+    run_count(t, job, nthreads);
+}
+
+/**
+ * ? Count votes [first, last) of an interned vote log.
+ *
+ * The log's rep ids are first mapped to candidate ids (one hash lookup per
+ * distinct rep), after which each vote costs a single array load instead
+ * of hashing a 32-byte name. Ranges shorter than the number of distinct
+ * reps are looked up by name directly.
+ *
+ * @param t         Tally with all candidates already added.
+ * @param log       Vote log to read.
+ * @param first     First vote to count.
+ * @param last      One past the last vote to count.
+ * @param nthreads  Worker threads (0: `TALLY_THREADS`); see run_count().
+ */
+void tally_count_log(Tally *t, const VoteLog *log, int first, int last, int nthreads) {
+    int *cand = last - first >= log->reps.count
+              ? malloc((log->reps.count ? log->reps.count : 1) * sizeof *cand) : NULL;
+    if (!cand) {
+        for (int i = first; i < last; i++) {
+            int id = name_index_get(&t->ids, vote_log_rep(log, i));
+            if (id >= 0) t->counts[id]++;
+        }
+        return;
+    }
+    for (int r = 0; r < log->reps.count; r++)
+        cand[r] = name_index_get(&t->ids, intern_name(&log->reps, r));
+    TallySlice job = { .rep = log->rep, .cand = cand, .first = first, .last = last };
+    run_count(t, job, nthreads);
+    free(cand);
+}
+
+/**
+ * ? Count a single vote whose rep username is a (pointer, length) field.
+ *
+ * Used by zero-copy readers that iterate a memory-mapped votes file.
+ */
+void tally_count_rep(Tally *t, const char *rep, size_t len) {
+    int id = name_index_get_n(&t->ids, rep, len);
+    if (id >= 0) t->counts[id]++;
+}
+
+/**
+ * ? Number of votes counted for a candidate.
+ *
+ * @return The vote count, or 0 if `rep_username` is not a candidate.
+ */
+int tally_votes_for(const Tally *t, const char *rep_username) {
+    int id = name_index_get(&t->ids, rep_username);
+    return id >= 0 ? t->counts[id] : 0;
+}
+
+/**
+ * ? Check running counters against a full recount.
+ *
+ * Recounts the whole log from scratch over the same candidates and
+ * compares every counter.
+ *
+ * @param t          Tally maintained incrementally.
+ * @param log        Complete vote log.
+ * @return           Number of candidates whose count differs; -1 on
+ *                   memory allocation failure.
+ */
+int tally_verify(const Tally *t, const VoteLog *log) {
+    Tally fresh;
+    if (tally_init(&fresh, t->count) != 0) return -1;
+    for (int i = 0; i < t->count; i++) {
+        if (tally_add_candidate(&fresh, t->names[i]) < 0) {
+            tally_free(&fresh);
+            return -1;
+        }
+    }
+    tally_count_log(&fresh, log, 0, log->count, 0);
+
+    int mismatches = 0;
+    for (int i = 0; i < t->count; i++)
+        if (fresh.counts[i] != t->counts[i]) mismatches++;
+    tally_free(&fresh);
+    return mismatches;
+}
+
+/**
+ * ? Release the memory held by a tally.
+ */
+void tally_free(Tally *t) {
+    name_index_free(&t->ids);
+    free(t->names);
+    free(t->counts);
+    t->names = NULL;
+    t->counts = NULL;
+    t->count = t->cap = 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "userstore.h"
+#include "fileio.h"
+
+/**
+ * ? Load users.txt into memory and index it by username.
+ *
+ * Parses the file once; later logins and duplicate checks are hash lookups
+ * instead of a full reparse and linear scan. When a username appears more
+ * than once the first entry wins, as with the old top-down scan, so a stray
+ * later line cannot take over an account (e.g. the default admin).
+ *
+ * @param s  Store to fill (previous contents are not freed).
+ * @return   Number of users loaded; -1 on memory allocation failure.
+ *
+ * * Usage:
+ *   - Called from main() once the startup checks have fixed users.txt.
+ */
+int user_store_load(UserStore *s) {
+    s->count = load_users(&s->users);
+    s->cap = s->count;
+    if (name_index_init(&s->index, s->count) != 0) return -1;
+    int duplicates = 0;
+    for (int i = 0; i < s->count; i++) {
+        if (name_index_get(&s->index, s->users[i].username) >= 0) {
+            duplicates++;
+            continue;
+        }
+        if (name_index_put(&s->index, s->users[i].username, i) != 0) return -1;
+    }
+    if (duplicates > 0)
+        fprintf(stderr, "[WARNING] %s: %d duplicate username line(s) ignored; the first entry of each is used.\n",
+                Users_Path, duplicates);
+    return s->count;
+}
+
+/**
+ * ? Find a user by username.
+ *
+ * @return Pointer into the store (valid until the next user_store_add),
+ *         or NULL if no such user exists.
+ */
+const User *user_store_find(const UserStore *s, const char *uname) {
+    int i = name_index_get(&s->index, uname);
+    return i >= 0 ? &s->users[i] : NULL;
+}
+
+/**
+ * ? Register a new user in memory and on disk.
+ *
+ * Appends the record to users.txt (one line, no rewrite) and to the
+ * in-memory array, then indexes it.
+ *
+ * @param s  Store to update.
+ * @param u  New user; the username must not already exist.
+ * @return   0 on success; -1 on I/O or memory errors.
+ */
+int user_store_add(UserStore *s, const User *u) {
+    if (s->count == s->cap) {
+        int cap = s->cap ? s->cap * 2 : 4;
+        User *grown = realloc(s->users, cap * sizeof *grown);
+        if (!grown) return -1;
+        s->users = grown;
+        s->cap = cap;
+    }
+    if (append_user(u) != 0) return -1;
+    s->users[s->count] = *u;
+    if (name_index_put(&s->index, u->username, s->count) != 0) return -1;
+    s->count++;
+    return 0;
+}
+
+/**
+ * ? Release the memory held by a store.
+ */
+void user_store_free(UserStore *s) {
+    free(s->users);
+    name_index_free(&s->index);
+    s->users = NULL;
+    s->count = s->cap = 0;
+}
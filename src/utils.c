@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include "fileio.h"
+#include "metrics.h"
 #include <stdlib.h>
 #include <locale.h>
 
@@ -12,43 +13,33 @@ int get_int(int min, int max);  // Private helper
 /**
  * Authenticate user by username and password.
  *
+ * @param store      The in-memory user store built at startup.
  * @param username   The username to look up.
  * @param password   The password to verify.
  * @param outUser    Pointer to a User structure where matching user data will be stored.
  * @return           1 on successful authentication (outUser populated), 0 otherwise.
  *
  * How it works:
- *   1. Calls `load_users(&users)` to load all users into a dynamically allocated array `users`,
- *      returning the count of users.
- *   2. Iterates over the `users` array, comparing both username and password.
- *   3. If a match is found:
- *        - Copies the matched user into `*outUser`.
- *        - Frees the `users` array.
- *        - Returns 1.
- *   4. If no match is found after checking all users:
- *        - Frees the `users` array.
- *        - Returns 0.
+ *   1. Looks `username` up in the store's hash index (no file access).
+ *   2. If found and the password matches, copies the user into `*outUser`
+ *      and returns 1. An admin-role entry other than the default admin
+ *      (e.g. added to users.txt by hand since startup) is refused.
+ *   3. Otherwise returns 0.
  *
  * Usage context:
- *   - Employed in both login (authentication) and registration (to check for existing credentials).
- *   - Called whenever a user attempts to log in or register.
+ *   - Called whenever a user attempts to log in.
  *   - Helps prevent unauthorized access by verifying provided credentials.
- *   - Ensures memory management by freeing the loaded user list after use.
  */
 
-int authenticate(const char *username, const char *password, User *outUser) {
-    User *users;
-    int count = load_users(&users);
-    for (int i = 0; i < count; i++) {
-        if (strcmp(username, users[i].username) == 0 &&
-            strcmp(password, users[i].password) == 0) {
-            *outUser = users[i];
-            free(users);
-            return 1;
-        }
-    }
-    free(users);
-    return 0;
+int authenticate(const UserStore *store, const char *username, const char *password, User *outUser) {
+    METRIC_START(t);
+    const User *u = user_store_find(store, username);
+    //* only the default admin may log in with the admin role
+    int ok = u && !(u->role == ROLE_ADMIN && strcmp(u->username, INIT_ADMIN_USERNAME) != 0) &&
+             strcmp(password, u->password) == 0;
+    if (ok) *outUser = *u;
+    METRIC_STOP(MET_AUTHENTICATE, t);
+    return ok;
 }
 
 /**
@@ -80,7 +71,7 @@ void get_string(const char *prompt, char *buf, int maxlen) {
         size_t len = strlen(buf);
 
         // If input filled buffer and last char is not newline, flush rest of line
-        if (len == maxlen - 1 && buf[len - 1] != '\n') {
+        if (len == (size_t)maxlen - 1 && buf[len - 1] != '\n') {
             int ch;
             while ((ch = getchar()) != '\n' && ch != EOF);
             printf("Input too long! Limit to %d characters.\n", maxlen - 1);
@@ -124,13 +115,15 @@ int main_prompt() {
  *   1 – List student representatives
  *   2 – View votes
  *   3 – Publish results
+ *   4 – Verify tallies
+ *   5 – Show metrics
  *   0 – Logout
  *
- * @return An integer corresponding to the chosen action (0–3).
+ * @return An integer corresponding to the chosen action (0–5).
  *
  * Behavior:
  *   - Outputs the admin menu options to stdout.
- *   - Uses `get_int(0, 3)` to validate and read the user's choice.
+ *   - Uses `get_int(0, 5)` to validate and read the user's choice.
  *
  * Usage context:
  *   - Called from the main admin loop.
@@ -138,8 +131,8 @@ int main_prompt() {
  *   - Ensures logically restricted and safe input in managing election operations.
  */
 int admin_prompt() {
-    printf("\nAdmin Menu:\n1. Student Representatives list\n2. View Votes\n3. Publish Results\n0. Logout\nSelect: ");
-    return get_int(0, 3);
+    printf("\nAdmin Menu:\n1. Student Representatives list\n2. View Votes\n3. Publish Results\n4. Verify Tallies\n5. Show Metrics\n0. Logout\nSelect: ");
+    return get_int(0, 5);
 }
 
 /**
@@ -203,11 +196,9 @@ int get_int(int min, int max) {
 /**
  * Check whether a username already exists in the system.
  *
- * Iterates through a list of User records to determine if any user’s
- * `username` matches the given `uname`.
+ * Looks `uname` up in the user store's hash index.
  *
- * @param users  Pointer to the first element in a User array.
- * @param count  Number of entries in the array.
+ * @param store  The in-memory user store.
  * @param uname  Null-terminated string to check for existence.
  * @return       `true` if a matching username is found, `false` otherwise.
  *
@@ -215,11 +206,8 @@ int get_int(int min, int max) {
  *   - Used during registration to ensure username uniqueness.
  *   - Prevents duplicate usernames, enforcing a unique identifier per user.
  */
-bool username_exists(User *users, int count, const char *uname) {
-    for (int i = 0; i < count; i++) {
-        if (strcmp(users[i].username, uname) == 0) return true;
-    }
-    return false;
+bool username_exists(const UserStore *store, const char *uname) {
+    return user_store_find(store, uname) != NULL;
 }
 
 /**
@@ -339,3 +327,26 @@ void username_guideline(){
 void logging_out(){
     printf("\n[Waiting] Logging out...\n====================\n\n");
 }
+
+/**
+ * Print `s` as a quoted JSON string.
+ *
+ * Escapes quotes, backslashes and control characters; other bytes are
+ * copied as-is (usernames and manifestos are UTF-8 or ASCII).
+ *
+ * @param out  Destination stream.
+ * @param s    Null-terminated string.
+ *
+ * Usage context:
+ *   - `election tally --json` and the JSON results export.
+ */
+void json_print_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <string.h>
+#include "votelog.h"
+
+/**
+ * ? Prepare an empty vote log.
+ *
+ * @param log       Log to initialize.
+ * @param expected  Expected number of votes (sizing hint).
+ * @return          0 on success; -1 on memory allocation failure.
+ */
+int vote_log_init(VoteLog *log, int expected) {
+    memset(log, 0, sizeof *log);
+    if (intern_init(&log->students, expected) != 0 ||
+        intern_init(&log->reps, 16) != 0) {
+        vote_log_free(log);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * ? Grow both id columns to hold at least `need` votes (doubling).
+ *
+ * @return 0 on success; -1 on memory allocation failure.
+ */
+static int reserve(VoteLog *log, int need) {
+    if (need <= log->cap) return 0;
+    int cap = log->cap ? log->cap : 16;
+    while (cap < need) cap *= 2;
+    uint32_t *student = realloc(log->student, cap * sizeof *student);
+    if (!student) return -1;
+    log->student = student;
+    uint32_t *rep = realloc(log->rep, cap * sizeof *rep);
+    if (!rep) return -1;
+    log->rep = rep;
+    log->cap = cap;
+    return 0;
+}
+
+/**
+ * ? Append ballots, interning their usernames.
+ *
+ * @param log    Log to extend.
+ * @param votes  Ballots in log order.
+ * @param count  Number of ballots.
+ * @return       0 on success; -1 on an empty username or memory allocation
+ *               failure (the ballots appended before it are kept).
+ */
+int vote_log_append(VoteLog *log, const Vote *votes, int count) {
+    if (reserve(log, log->count + count) != 0) return -1;
+    for (int i = 0; i < count; i++) {
+        //! the student is interned last: being interned means having voted
+        if (!votes[i].student_username[0] || !votes[i].rep_username[0]) return -1;
+        int r = intern_id(&log->reps, votes[i].rep_username);
+        int s = r < 0 ? -1 : intern_id(&log->students, votes[i].student_username);
+        if (s < 0) return -1;
+        log->student[log->count] = s;
+        log->rep[log->count] = r;
+        log->count++;
+    }
+    return 0;
+}
+
+/**
+ * ? Check whether a student has a ballot in the log.
+ *
+ * One hash lookup: only students who voted are ever interned.
+ */
+bool vote_log_has_voted(const VoteLog *log, const char *student) {
+    return intern_find(&log->students, student) >= 0;
+}
+
+/**
+ * ? Username of the student who cast vote `i`.
+ */
+const char *vote_log_student(const VoteLog *log, int i) {
+    return intern_name(&log->students, log->student[i]);
+}
+
+/**
+ * ? Username of the rep vote `i` was cast for.
+ */
+const char *vote_log_rep(const VoteLog *log, int i) {
+    return intern_name(&log->reps, log->rep[i]);
+}
+
+/**
+ * ? Release the memory held by a vote log.
+ */
+void vote_log_free(VoteLog *log) {
+    intern_free(&log->students);
+    intern_free(&log->reps);
+    free(log->student);
+    free(log->rep);
+    memset(log, 0, sizeof *log);
+}